@@ -0,0 +1,87 @@
+// Throughput of the batched 3x3 board evaluator against the scalar functions, run with meson test --benchmark or directly.
+// usage: board_batch [rounds]
+//
+// Every one of the 3^9 ways to fill the board is evaluated, repeated to a batch of BATCH_SIZE boards, first one at a
+// time with evaluateBoard and isBitboardDeadDraw as the search does, then with evaluateBoardBatch.
+// Fails if the two disagree on any board.
+#include <string.h>
+#include <include/minimax.h>
+#include <include/board_batch.h>
+
+#define BATCH_SIZE (1 << 20)
+#define DEFAULT_ROUNDS 20
+
+static uint16_t cross[BATCH_SIZE];
+static uint16_t nought[BATCH_SIZE];
+static uint8_t scalarStatus[BATCH_SIZE];
+static uint8_t batchStatus[BATCH_SIZE];
+
+// what the search works out for a position today: evaluateBoard for a win, then the dead draw test
+static void evaluateScalar(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        Bitboard board = {cross[i], nought[i]};
+        int score = evaluateBoard(board);
+        if (score == 10)
+            scalarStatus[i] = BOARD_CROSS_WON;
+        else if (score == -10)
+            scalarStatus[i] = BOARD_NOUGHT_WON;
+        else
+            scalarStatus[i] = isBitboardDeadDraw(board) ? BOARD_DRAWN : BOARD_ONGOING;
+    }
+}
+
+int main(int argc, char **argv){
+    int rounds = argc > 1 ? max(1, atoi(argv[1])) : DEFAULT_ROUNDS;
+
+    // cell i of position p is digit i of p in base 3: empty, X or O
+    for (int i = 0; i < BATCH_SIZE; i++)
+    {
+        int position = i % 19683;
+        cross[i] = 0;
+        nought[i] = 0;
+        for (int cell = 0; cell < 9; cell++, position /= 3)
+        {
+            if (position % 3 == BOARD_CROSS)
+                cross[i] |= 1 << cell;
+            else if (position % 3 == BOARD_NOUGHT)
+                nought[i] |= 1 << cell;
+        }
+    }
+
+    // best of several rounds, the first ones pay for page faults and frequency changes
+    double scalarMs = 0;
+    double batchMs = 0;
+    BoardBatch batch = {cross, nought, BATCH_SIZE};
+    for (int round = 0; round < rounds; round++)
+    {
+        long long start = currentTimeMicros();
+        evaluateScalar(BATCH_SIZE);
+        double ms = (currentTimeMicros() - start) / 1000.0;
+        scalarMs = round == 0 ? ms : (ms < scalarMs ? ms : scalarMs);
+
+        start = currentTimeMicros();
+        evaluateBoardBatch(&batch, batchStatus);
+        ms = (currentTimeMicros() - start) / 1000.0;
+        batchMs = round == 0 ? ms : (ms < batchMs ? ms : batchMs);
+    }
+
+    int counts[4] = {0};
+    for (int i = 0; i < BATCH_SIZE; i++)
+    {
+        if (scalarStatus[i] != batchStatus[i])
+        {
+            println("board %d (X %03x, O %03x): batch says %d, scalar says %d", i, cross[i], nought[i], batchStatus[i], scalarStatus[i]);
+            return 1;
+        }
+        counts[batchStatus[i]]++;
+    }
+
+    println("kernel: %s", boardBatchKernel());
+    println("%d boards: %d ongoing, %d X won, %d O won, %d drawn", BATCH_SIZE, counts[BOARD_ONGOING],
+            counts[BOARD_CROSS_WON], counts[BOARD_NOUGHT_WON], counts[BOARD_DRAWN]);
+    println("scalar: %8.3f ms, %7.1f million boards/s", scalarMs, BATCH_SIZE / scalarMs / 1000.0);
+    println("batch:  %8.3f ms, %7.1f million boards/s, %.1fx", batchMs, BATCH_SIZE / batchMs / 1000.0, scalarMs / batchMs);
+    return 0;
+}
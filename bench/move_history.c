@@ -0,0 +1,136 @@
+// Check of the move history, run with meson test or directly.
+// usage: move_history [games]
+//
+// Plays random games on every preset board and on boards that build their own line table, mixing doMove, undo, redo
+// and jumpToPly. After every step the game is compared with a fresh one that only replays the moves on the board with
+// doMove and nextTurn: the board, whose turn it is and the line counts have to match. Against the AI, undo and redo
+// also have to leave the player to move. Fails on the first difference.
+#include <string.h>
+#include <include/game.h>
+
+#define DEFAULT_GAMES 2000
+// steps of one game, enough to play most boards out and to walk back and forth over it a few times
+#define STEPS_PER_GAME 200
+
+// boards checked besides the presets, createGameState builds their line tables the first time one is played
+static const BoardConfig CUSTOM_BOARDS[] = {{6, 4}, {7, 5}, {9, 3}};
+#define CUSTOM_BOARD_COUNT (int)(sizeof(CUSTOM_BOARDS) / sizeof(CUSTOM_BOARDS[0]))
+
+// what a step did, for the report of a mismatch
+static const char *STEP_NAMES[] = {"doMove", "undo", "redo", "jumpToPly"};
+
+// plays a random empty cell for whoever is to move, returns false when the game is over or the board is full
+static bool playRandomMove(GameState *state){
+    if(checkWin(state) || checkDraw(state))
+        return false;
+    int size = state->config.size;
+    int start = rand() % (size * size);
+    for(int i = 0; i < size * size; i++){
+        int cell = (start + i) % (size * size);
+        if(doMove(state, cell / size, cell % size)){
+            nextTurn(state);
+            return true;
+        }
+    }
+    return false;
+}
+
+// compares state with a fresh game that replays its moves on the board, prints the first difference
+static bool matchesReplay(const GameState *state){
+    static GameState replay;
+    createGameState(&replay, state->opponent, state->config);
+    replay.player1StartFirst = state->player1StartFirst;
+    replay.turn = state->player1StartFirst ? PLAYER_1 : state->opponent;
+    for(int ply = 0; ply < state->history.current; ply++){
+        const MoveRecord *move = moveAt(&state->history, ply);
+        if(move->player != replay.turn){
+            println("ply %d was played by %d, the replay has %d to move", ply, move->player, replay.turn);
+            return false;
+        }
+        doMove(&replay, move->row, move->col);
+        nextTurn(&replay);
+    }
+
+    if(memcmp(state->board, replay.board, sizeof(state->board)) != 0){
+        println("boards differ after %d moves", state->history.current);
+        return false;
+    }
+    if(state->turn != replay.turn || state->movesMade != replay.movesMade){
+        println("turn %d and %d moves made, the replay has turn %d and %d moves made", state->turn, state->movesMade,
+                replay.turn, replay.movesMade);
+        return false;
+    }
+    const LineCounts *lines = &state->lineCounts;
+    const LineCounts *expected = &replay.lineCounts;
+    int lineCount = state->lines->lineCount;
+    if(memcmp(lines->counts, expected->counts, sizeof(lines->counts[0]) * lineCount) != 0
+       || memcmp(lines->cellOpenLines, expected->cellOpenLines, sizeof(lines->cellOpenLines)) != 0
+       || lines->openLines != expected->openLines || lines->completedLines != expected->completedLines
+       || lines->patternScore != expected->patternScore || lines->threats[0] != expected->threats[0]
+       || lines->threats[1] != expected->threats[1]){
+        println("line counts differ after %d moves: %d open, %d completed, pattern %d, the replay has %d, %d and %d",
+                state->history.current, lines->openLines, lines->completedLines, lines->patternScore,
+                expected->openLines, expected->completedLines, expected->patternScore);
+        return false;
+    }
+    return true;
+}
+
+// plays one random game on config, returns false on the first step that leaves it different from its replay
+static bool checkGame(BoardConfig config, PlayerType opponent){
+    static GameState state;
+    createGameState(&state, opponent, config);
+    for(int step = 0; step < STEPS_PER_GAME; step++){
+        // mostly new moves, so games get deep enough to be won or drawn before they are walked back
+        int kind = rand() % 8;
+        int before = state.history.current;
+        kind = kind < 4 ? 0 : kind - 4;
+        if(kind == 0){
+            if(!playRandomMove(&state))
+                kind = 3;
+        }else if(kind == 1){
+            undo(&state);
+        }else if(kind == 2){
+            redo(&state);
+        }
+        if(kind == 3){
+            int ply = rand() % (state.history.count + 1);
+            if(!jumpToPly(&state, ply)){
+                println("jumpToPly(%d) refused with %d moves recorded", ply, state.history.count);
+                return false;
+            }
+        }
+        // against the AI, an undo or redo that moved stops on the player's turn, unless redo ran out of moves
+        bool walked = (kind == 1 || kind == 2) && state.history.current != before;
+        bool stoppedOnAi = walked && opponent == AI && state.turn != state.player && state.history.current != state.history.count;
+        if(stoppedOnAi)
+            println("%s stopped on the AI's turn after %d moves", STEP_NAMES[kind], state.history.current);
+        if(stoppedOnAi || state.history.current > state.history.count || !matchesReplay(&state)){
+            println("%dx%d with %d in a row against %s, step %d: %s", config.size, config.size, config.winLength,
+                    opponent == AI ? "the AI" : "player 2", step, STEP_NAMES[kind]);
+            return false;
+        }
+    }
+    destroyGameState(&state);
+    return true;
+}
+
+int main(int argc, char **argv){
+    int games = argc > 1 ? max(1, atoi(argv[1])) : DEFAULT_GAMES;
+    // the same games every run, so a failure can be reproduced
+    srand(1);
+
+    int boardCount = BOARD_PRESET_COUNT + CUSTOM_BOARD_COUNT;
+    long long start = currentTimeMillis();
+    for(int game = 0; game < games; game++){
+        int board = game % boardCount;
+        BoardConfig config = board < BOARD_PRESET_COUNT ? BOARD_PRESETS[board] : CUSTOM_BOARDS[board - BOARD_PRESET_COUNT];
+        PlayerType opponent = (game / boardCount) % 2 == 0 ? AI : PLAYER_2;
+        if(!checkGame(config, opponent)){
+            println("game %d differs from its replay", game);
+            return 1;
+        }
+    }
+    println("%d games of %d steps match their replays, %lld ms", games, STEPS_PER_GAME, currentTimeMillis() - start);
+    return 0;
+}
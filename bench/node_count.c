@@ -0,0 +1,134 @@
+// Node count benchmark, the perft of the search engine. Run with meson test --benchmark or directly.
+// Searches a fixed suite of positions to fixed depths on a single thread and prints the nodes visited, the effective
+// branching factor (the depth-th root of the nodes, how many moves every node searched on average), nodes per second
+// and time per move. The searches are deterministic, so the node counts only change when the search itself does: the
+// benchmark fails when one differs from its expectedNodes. After an intended change run it with -u to print the new
+// counts and paste them into SUITE.
+#include <string.h>
+#include <include/minimax.h>
+#include <include/game.h>
+
+typedef struct NodeCountPosition{
+    const char *name;
+    BoardConfig config;
+    int depth;
+    const char *moves; // cells as "row,col" pairs separated by spaces, X first
+    bool easy; // searched by findBestMove like the Easy difficulty, otherwise by solvePosition
+    unsigned long long expectedNodes;
+}NodeCountPosition;
+
+// findBestMove only searches to a fixed depth on 3x3 below CLASSIC_MAX_DEPTH, anything deeper runs against the clock,
+// so the other entries go through solvePosition which always searches exactly to the given depth
+static const NodeCountPosition SUITE[] = {
+    {"3x3 empty", {3, 3}, 1, "", true, 19},
+    {"3x3 empty", {3, 3}, 2, "", true, 41},
+    {"3x3 empty", {3, 3}, 8, "", true, 548},
+    {"3x3 corner", {3, 3}, 8, "0,0", true, 348},
+    {"3x3 center", {3, 3}, 8, "1,1", false, 1075},
+    {"4x4 two pieces", {4, 4}, 10, "1,1 2,2", false, 49757},
+    {"4x4 two pieces", {4, 4}, 16, "0,0 1,1", false, 71505},
+    {"5x5 three pieces", {5, 4}, 8, "2,2 1,2 2,1", false, 263855},
+    {"15x15 opening", {15, 5}, 5, "7,7 7,8 8,7 6,6", false, 475387},
+    {"15x15 opening", {15, 5}, 6, "7,7 7,8 8,7 6,6", false, 4228776},
+};
+#define SUITE_SIZE (int)(sizeof(SUITE) / sizeof(SUITE[0]))
+
+// Searches shorter than this are repeated until they add up to it, so the small ones get a measurable time
+#define MIN_BENCH_MS 100
+
+// returns the number of pieces placed
+static int setupBoard(const NodeCountPosition *position, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]){
+    for(int i = 0; i < MAX_BOARD_SIZE; i++)
+        for(int j = 0; j < MAX_BOARD_SIZE; j++)
+            board[i][j] = BOARD_EMPTY;
+
+    const char *p = position->moves;
+    int pieces = 0;
+    int row, col, used;
+    while(sscanf(p, "%d,%d%n", &row, &col, &used) == 2){
+        board[row][col] = pieces % 2 == 0 ? BOARD_CROSS : BOARD_NOUGHT;
+        pieces++;
+        p += used;
+    }
+    return pieces;
+}
+
+int main(int argc, char **argv){
+    bool update = argc > 1 && strcmp(argv[1], "-u") == 0;
+
+    // collisions in the transposition tables change the node counts, they only hold for the default sizes
+    bool defaultTables = TRANSPOSITION_TABLE_SIZE == 4096 && SHARED_TRANSPOSITION_TABLE_SIZE == (1 << 20);
+    if(!defaultTables)
+        println("Transposition tables aren't the default size, node counts are reported but not checked");
+
+    SearchContext *context = createSearchContext(1, 1);
+    // the first search allocates the shared transposition table and faults its pages in, keep that out of the timings
+    int warmup[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+    setupBoard(&SUITE[SUITE_SIZE - 1], warmup);
+    context->maxDepth = 4;
+    findBestMove(context, warmup, SUITE[SUITE_SIZE - 1].config, AI, true);
+
+    println("position               board  depth        nodes     expected    EBF  ms per move    knodes/s  move");
+    int failures = 0;
+    unsigned long long nodeCounts[SUITE_SIZE];
+    unsigned long long totalNodes = 0;
+    double totalTime = 0;
+    for(int i = 0; i < SUITE_SIZE; i++){
+        const NodeCountPosition *position = &SUITE[i];
+        int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+        int pieces = setupBoard(position, board);
+        context->maxDepth = position->depth;
+
+        Pair move;
+        int runs = 0;
+        long long start = currentTimeMillis();
+        long long elapsed;
+        do{
+            int copy[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+            memcpy(copy, board, sizeof(copy));
+            if(position->easy){
+                // the AI plays whoever is to move, O when X has one more piece
+                move = findBestMove(context, copy, position->config, AI, pieces % 2 == 1);
+            }else{
+                int value;
+                move = solvePosition(context, copy, position->config, pieces % 2 == 0 ? BOARD_CROSS : BOARD_NOUGHT, &value);
+            }
+            runs++;
+            elapsed = currentTimeMillis() - start;
+        }while(elapsed < MIN_BENCH_MS);
+        double msPerMove = (double)elapsed / runs;
+        unsigned long long nodes = context->stats.nodes;
+        nodeCounts[i] = nodes;
+        totalNodes += nodes;
+        totalTime += msPerMove;
+
+        // the search can't go deeper than the board has empty cells
+        int plies = min(position->depth, position->config.size * position->config.size - pieces);
+        double branching = pow((double)nodes, 1.0 / plies);
+
+        bool matches = nodes == position->expectedNodes;
+        if(!matches && defaultTables && !update)
+            failures++;
+        println("%-22s %2dx%-2d %6d %12llu %12llu %6.2f %12.3f %11.0f  %d,%d%s", position->name, position->config.size, position->config.winLength,
+                position->depth, nodes, position->expectedNodes, branching, msPerMove, nodes / msPerMove, move.a, move.b,
+                matches ? "" : "  MISMATCH");
+    }
+
+    println("");
+    println("total %llu nodes in %.1f ms, %.0f knodes/s, %.1f ms per move on average", totalNodes, totalTime,
+            totalNodes / totalTime, totalTime / SUITE_SIZE);
+
+    if(update){
+        println("");
+        println("expected node counts for SUITE, in order:");
+        for(int i = 0; i < SUITE_SIZE; i++)
+            println("%s, depth %d: %llu", SUITE[i].name, SUITE[i].depth, nodeCounts[i]);
+    }
+    destroySearchContext(context);
+
+    if(failures > 0){
+        println("%d node counts differ from the expected ones, the search changed", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Scaling benchmark for the multithreaded search, run with meson test --benchmark or directly.
+// Searches a few fixed positions to a fixed depth with 1, 2, 4... threads up to the number of cores
+// (or the thread count given as the first argument) and prints nodes per second and the speedup over a single thread.
+#include <include/minimax.h>
+#include <include/game.h>
+
+typedef struct BenchPosition{
+    const char *name;
+    BoardConfig config;
+    int depth;
+    const char *moves; // cells as "row,col" pairs separated by spaces, X first
+}BenchPosition;
+
+static const BenchPosition POSITIONS[] = {
+    {"4x4, 4 in a row", {4, 4}, 8, "1,1 2,2"},
+    {"5x5, 4 in a row", {5, 4}, 8, "2,2 1,2 2,1"},
+    {"15x15, 5 in a row", {15, 5}, 6, "7,7 7,8 8,7 6,6"},
+};
+#define POSITION_COUNT (int)(sizeof(POSITIONS) / sizeof(POSITIONS[0]))
+
+static void setupBoard(const BenchPosition *position, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]){
+    for(int i = 0; i < MAX_BOARD_SIZE; i++)
+        for(int j = 0; j < MAX_BOARD_SIZE; j++)
+            board[i][j] = BOARD_EMPTY;
+
+    const char *p = position->moves;
+    int piece = BOARD_CROSS;
+    int row, col, used;
+    while(sscanf(p, "%d,%d%n", &row, &col, &used) == 2){
+        board[row][col] = piece;
+        piece = piece == BOARD_CROSS ? BOARD_NOUGHT : BOARD_CROSS;
+        p += used;
+    }
+}
+
+int main(int argc, char **argv){
+    int cores = argc > 1 ? max(1, atoi(argv[1])) : cpuCount();
+    println("Parallel search scaling, up to %d threads", cores);
+
+    // the first search allocates the shared transposition table and faults its pages in, keep that out of the timings
+    int warmup[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+    setupBoard(&POSITIONS[POSITION_COUNT - 1], warmup);
+    SearchContext *context = createSearchContext(POSITIONS[POSITION_COUNT - 1].depth - 1, 1);
+    findBestMove(context, warmup, POSITIONS[POSITION_COUNT - 1].config, AI, true);
+
+    for(int i = 0; i < POSITION_COUNT; i++){
+        const BenchPosition *position = &POSITIONS[i];
+        int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+        setupBoard(position, board);
+        // the AI plays whoever is to move, O when X has one more piece
+        int pieces = 0;
+        for(int r = 0; r < position->config.size; r++)
+            for(int c = 0; c < position->config.size; c++)
+                pieces += board[r][c] != BOARD_EMPTY;
+        bool playerStartFirst = pieces % 2 == 1;
+
+        println("");
+        println("%s, depth %d", position->name, position->depth);
+        println("threads        nodes    time ms    knodes/s  speedup  move");
+        long long singleTime = 0;
+        for(int threads = 1; threads <= cores; threads = threads < cores && threads * 2 > cores ? cores : threads * 2){
+            context->threads = threads;
+            context->maxDepth = position->depth;
+            int copy[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+            for(int r = 0; r < MAX_BOARD_SIZE; r++)
+                for(int c = 0; c < MAX_BOARD_SIZE; c++)
+                    copy[r][c] = board[r][c];
+
+            long long start = currentTimeMillis();
+            Pair move = findBestMove(context, copy, position->config, AI, playerStartFirst);
+            long long elapsed = max(1, (int)(currentTimeMillis() - start));
+            if(threads == 1)
+                singleTime = elapsed;
+
+            println("%7d %12llu %10lld %11.0f %8.2f  %d,%d", threads, context->stats.nodes, elapsed,
+                    (double)context->stats.nodes / elapsed, (double)singleTime / elapsed, move.a, move.b);
+            if(threads == cores)
+                break;
+        }
+    }
+    destroySearchContext(context);
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Ultimate tic-tac-toe speed benchmark, run with meson test --benchmark or directly.
+// usage: ultimate_selfplay [games] [ms per move]
+//
+// First plays random games to measure the rules alone (move generation and playing moves), then lets the engine
+// play itself with a fixed time per move and prints moves per second, nodes per second, the depth reached and the results.
+#include <string.h>
+#include <include/ultimate_search.h>
+
+#define RANDOM_GAMES 200000
+#define DEFAULT_GAMES 4
+#define DEFAULT_MOVE_MS 100
+
+int main(int argc, char **argv){
+    int games = argc > 1 ? max(1, atoi(argv[1])) : DEFAULT_GAMES;
+    int moveMs = argc > 2 ? max(1, atoi(argv[2])) : DEFAULT_MOVE_MS;
+    srand(1);
+
+    // random playouts, every move generates the legal moves and plays one of them
+    unsigned long long randomMoves = 0;
+    int randomResults[4] = {0};
+    long long start = currentTimeMicros();
+    for(int game = 0; game < RANDOM_GAMES; game++){
+        UltimateBoard board;
+        initUltimateBoard(&board);
+        uint8_t moves[ULTIMATE_CELLS];
+        int count;
+        while((count = generateUltimateMoves(&board, moves)) > 0){
+            playUltimateMove(&board, moves[rand() % count]);
+            randomMoves++;
+        }
+        randomResults[board.winner]++;
+    }
+    double randomMs = (currentTimeMicros() - start) / 1000.0;
+    println("random play: %d games, %llu moves in %.1f ms, %.2f million moves/s, %.1f moves per game",
+            RANDOM_GAMES, randomMoves, randomMs, randomMoves / randomMs / 1000.0, (double)randomMoves / RANDOM_GAMES);
+    println("             X won %d, O won %d, %d draws", randomResults[BOARD_CROSS], randomResults[BOARD_NOUGHT], randomResults[ULTIMATE_DRAW]);
+
+    // engine against itself, the first move of each game is random so the games differ
+    SearchContext *context = createSearchContext(CLASSIC_MAX_DEPTH, 1);
+    unsigned long long engineMoves = 0;
+    unsigned long long nodes = 0;
+    unsigned long long depths = 0;
+    double searchMs = 0;
+    int results[4] = {0};
+    for(int game = 0; game < games; game++){
+        UltimateBoard board;
+        initUltimateBoard(&board);
+        playUltimateMove(&board, rand() % ULTIMATE_CELLS);
+        while(board.winner == BOARD_EMPTY){
+            Pair move = findBestUltimateMove(context, &board, moveMs);
+            playUltimateMove(&board, ultimateMoveAt(move.a, move.b));
+            engineMoves++;
+            nodes += context->stats.nodes;
+            depths += context->stats.maxDepth;
+            searchMs += context->stats.timeMs;
+        }
+        results[board.winner]++;
+        println("game %d: %s after %d moves", game + 1,
+                board.winner == ULTIMATE_DRAW ? "draw" : board.winner == BOARD_CROSS ? "X won" : "O won", board.movesMade);
+    }
+    println("self-play: %d games at %d ms per move, %llu moves in %.1f ms, %.1f moves/s", games, moveMs, engineMoves,
+            searchMs, engineMoves / searchMs * 1000.0);
+    println("           %.0f knodes/s, %.1f plies deep on average, X won %d, O won %d, %d draws", nodes / searchMs,
+            (double)depths / engineMoves, results[BOARD_CROSS], results[BOARD_NOUGHT], results[ULTIMATE_DRAW]);
+    destroySearchContext(context);
+    return 0;
+}
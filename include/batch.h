@@ -0,0 +1,30 @@
+#include <util.h>
+#include <minimax.h>
+
+#ifndef BATCH_H
+#define BATCH_H
+
+/// @brief A position to analyse with solvePositions.
+typedef struct BatchPosition{
+    int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; // 0 for empty, 1 for X (Cross), 2 for nought (O)
+    BoardConfig config;
+    int toMove; // BOARD_CROSS or BOARD_NOUGHT
+}BatchPosition;
+
+/// @brief Result of one position, see solvePosition.
+typedef struct BatchResult{
+    Pair move; // best move for toMove, (-1, -1) if the game is already over
+    int value; // minimax score of the move for toMove, > 0 wins, < 0 loses, 0 draws or is undecided
+    unsigned long long nodes; // positions visited to solve it
+}BatchResult;
+
+/// @brief Solves many positions at once, spread over a pool of threads with one search context each.
+/// Threads take the next unsolved position as soon as they are done, so a few slow positions don't hold the others up.
+/// @param positions the positions to solve, left unchanged
+/// @param results out parameter, results[i] is the answer for positions[i]
+/// @param count number of positions
+/// @param maxDepth how many moves ahead every position is searched
+/// @param threads number of threads, cpuCount() uses every core
+void solvePositions(BatchPosition *positions, BatchResult *results, int count, int maxDepth, int threads);
+
+#endif
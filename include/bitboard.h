@@ -0,0 +1,90 @@
+#include <stdint.h>
+#include <util.h>
+#include <board_tables.h>
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+/// @brief Compact representation of the 3x3 board, one 9-bit occupancy mask per side.
+/// Bit (row * 3 + col) is set when that cell holds the piece. The whole position is 32 bits,
+/// so it is passed by value and lives in a register during the search instead of a 36 byte array.
+typedef struct Bitboard{
+    uint16_t cross; // cells holding BOARD_CROSS (1)
+    uint16_t nought; // cells holding BOARD_NOUGHT (2)
+}Bitboard;
+
+// Mask with all 9 cells set, a board whose occupancy equals this is full.
+#define BITBOARD_FULL 0x1FF
+
+// Number of winning lines on a 3x3 board (3 rows, 3 columns, 2 diagonals)
+#define WIN_LINE_COUNT 8
+
+// WIN_LINES, WINNING_MASKS, SYMMETRY_CELLS, INVERSE_SYMMETRY and SYMMETRY_MASKS come from board_tables.h,
+// generated at build time by tools/gen_board_tables.c.
+
+// Number of rotations and reflections of the square board, including the identity
+#define SYMMETRY_COUNT 8
+
+/// @brief Returns the bit for the cell at row, col.
+static inline uint16_t cellBit(int row, int col){
+    return (uint16_t)(1u << (row * 3 + col));
+}
+
+/// @brief Returns a mask of every occupied cell.
+static inline uint16_t occupiedCells(Bitboard board){
+    return board.cross | board.nought;
+}
+
+/// @brief Checks if a single side's mask covers any of the winning lines.
+/// @param mask occupancy mask of one side
+/// @return true if the side has three in a row
+static inline bool hasWinningLine(uint16_t mask){
+    return (WINNING_MASKS[mask >> 5] >> (mask & 31)) & 1;
+}
+
+/// @brief Checks if every cell of the board is taken.
+static inline bool isBitboardFull(Bitboard board){
+    return occupiedCells(board) == BITBOARD_FULL;
+}
+
+/// @brief Checks if every winning line holds at least one cross AND one nought, so nobody can win anymore.
+static inline bool isBitboardDeadDraw(Bitboard board){
+    for(int i = 0; i < WIN_LINE_COUNT; i++){
+        if((board.cross & WIN_LINES[i]) == 0 || (board.nought & WIN_LINES[i]) == 0)
+            return false;
+    }
+    return true;
+}
+
+/// @brief Converts the int array board used by GameState into a bitboard.
+/// @param board the tic-tac-toe board, 0 for empty, 1 for X (Cross), 2 for nought (O). Only the top left 3x3 is read.
+/// @return the equivalent bitboard
+Bitboard boardToBitboard(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]);
+
+/// @brief Writes a bitboard back into the int array representation used by GameState.
+/// @param bitboard the bitboard to convert
+/// @param board destination board, the top left 3x3 cells are overwritten
+void bitboardToBoard(Bitboard bitboard, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]);
+
+/// @brief Packs a bitboard into a single 18-bit key, crosses in the low 9 bits and noughts above.
+static inline uint32_t bitboardKey(Bitboard board){
+    return (uint32_t)board.cross | ((uint32_t)board.nought << 9);
+}
+
+/// @brief Applies one of the 8 board symmetries to a bitboard.
+/// @param board the position to transform
+/// @param symmetry index into SYMMETRY_CELLS
+/// @return the rotated or reflected position
+static inline Bitboard transformBitboard(Bitboard board, int symmetry){
+    Bitboard ret = {SYMMETRY_MASKS[symmetry][board.cross], SYMMETRY_MASKS[symmetry][board.nought]};
+    return ret;
+}
+
+/// @brief Finds the symmetry-canonical form of a position, the one of its 8 rotations and reflections with the smallest key.
+/// All symmetric positions share the same canonical form, so results stored under it are valid for all of them.
+/// @param board the position
+/// @param symmetry out parameter, the symmetry that maps board onto its canonical form
+/// @return the canonical position
+Bitboard canonicalBitboard(Bitboard board, int *symmetry);
+
+#endif
@@ -10,16 +10,19 @@ extern TF_Graph* graph;
 extern TF_Session* session;
 extern TF_Status* status;
 
+// cost of the last findBestDLMove, one network evaluation one move deep. timeMs is the TF_SessionRun latency.
+extern SearchStats dlStats;
+
 /// @brief loads the tensorflow model and initializes tensorflow into a state ready for inference
 /// @param model_path path of the saved_model FOLDER
 void init_tensorflow(const char* model_path);
 
 /// @brief performs inference on the current board state, using the best q values to find the best move
-/// @param board a copy of the tic tac toe board
+/// @param board a copy of the tic tac toe board, the model only plays 3x3 so only the top left 3x3 is read
 /// @param currentPlayer unused, for compatibility with minimax's findBestMove
 /// @param playerStartFirst unused, for compatibility with minimax's findBestMove,
 /// @return 
-Pair findBestDLMove(int board[3][3], PlayerType currentPlayer, bool playerStartFirst);
+Pair findBestDLMove(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], PlayerType currentPlayer, bool playerStartFirst);
 
 /// @brief cleans up the resources used by tensorflow to prevent memory leaks
 void cleanup_tensorflow();
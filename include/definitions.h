@@ -39,6 +39,29 @@ typedef enum PlayerType{
 #define BOARD_CROSS 1
 // Nought (O) definition for the ttt board.
 #define BOARD_NOUGHT 2
-// Global variable to store the maximum minimax depth, affects difficulty.
-extern int MAX_DEPTH;
+// Largest supported board is 15x15, board arrays are always allocated at this size and only the top left
+// size x size corner is used.
+#define MAX_BOARD_SIZE 15
+
+/// @brief Dimensions of an m,n,k game on a square board, size x size cells where winLength in a row wins.
+/// The classic game is {3, 3}.
+typedef struct BoardConfig{
+    int size; // number of rows and columns, up to MAX_BOARD_SIZE
+    int winLength; // number of pieces in a row (horizontal, vertical or diagonal) needed to win
+}BoardConfig;
+
+// Board sizes offered by the gui and tui, the initializer of BOARD_PRESETS. tools/gen_board_tables.c generates
+// the line tables and move orders of each of these at build time.
+#define BOARD_PRESET_LIST {3, 3}, {4, 4}, {5, 4}, {15, 5}
+
+/// @brief What the last AI move cost, filled in by minimax, monte carlo and the deep-q player after every move.
+/// Counters an AI doesn't have stay 0.
+typedef struct SearchStats{
+    unsigned long long nodes; // positions visited by minimax, playouts run by monte carlo, network evaluations by deep-q
+    int maxDepth; // deepest ply below the current position that was looked at
+    unsigned long long cutoffs; // alpha-beta cutoffs, including the ones straight from the transposition table
+    unsigned long long hashHits; // transposition table probes that found the position
+    double timeMs; // wall time of the move, for deep-q the inference latency
+}SearchStats;
+
 #endif
\ No newline at end of file
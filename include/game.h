@@ -1,13 +1,122 @@
+#include <stdint.h>
 #include <util.h>
-#include <linked_list.h>
+#include <move_history.h>
 
 #ifndef GAME_H
 #define GAME_H
 
-/// @brief The whole state of the game, individual parameters are documented in the header.
+// Upper bound on the number of winLength windows on a board, at most size * size start cells in each of the 4 directions.
+#define MAX_LINE_WINDOWS (4 * MAX_BOARD_SIZE * MAX_BOARD_SIZE)
+// Upper bound on the number of windows through one cell, at most winLength per direction.
+#define MAX_LINES_PER_CELL (4 * MAX_BOARD_SIZE)
+
+/// @brief Geometry of every winLength window ("line") on a board, and which of them go through each cell.
+/// A player wins by filling a line, and once every line holds both an X and an O nobody can win anymore.
+/// Cells are numbered row * MAX_BOARD_SIZE + col.
+typedef struct LineTable{
+    BoardConfig config; // the board the table was built for
+    int lineCount;
+    int16_t lineStart[MAX_LINE_WINDOWS]; // first cell of every line
+    int16_t lineStep[MAX_LINE_WINDOWS]; // distance between two cells of the line
+    uint8_t cellLineCount[MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // number of lines through every cell
+    int16_t cellLines[MAX_BOARD_SIZE * MAX_BOARD_SIZE][MAX_LINES_PER_CELL]; // indices of those lines
+}LineTable;
+
+/// @brief Piece counts of every line of one position, updated one move at a time with addLinePiece and removeLinePiece.
+typedef struct LineCounts{
+    uint8_t counts[MAX_LINE_WINDOWS][2]; // number of X (index 0) and O (index 1) in every line
+    uint8_t cellOpenLines[MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // open lines through every cell, a cell without any can't change the outcome
+    int openLines; // lines that don't hold both an X and an O yet, nobody can win anymore when this reaches 0
+    int completedLines; // lines filled by a single player
+    int patternScore; // sum of linePattern over every line, positive when the lines favour X
+    int threats[2]; // lines X (index 0) and O (index 1) can complete with their next piece
+}LineCounts;
+
+/// @brief Worth of a line only one side has pieces in, by the number of pieces that side still needs to complete it.
+/// Every piece less to go is worth 4 times as much, lines that need more than 4 are too far off to count.
+static const int LINE_PATTERN_WEIGHTS[MAX_BOARD_SIZE + 1] = {0, 64, 16, 4, 1};
+
+/// @brief Worth of a line to X: positive while only X holds it, negative while only O does, 0 while it is empty or
+/// blocked by both sides. An open two, three or four is a line with that many pieces of one side in it.
+/// @param counts number of X and O in the line
+/// @param winLength pieces needed to complete it
+static inline int linePattern(const uint8_t counts[2], int winLength){
+    if(counts[0] != 0 && counts[1] == 0)
+        return LINE_PATTERN_WEIGHTS[winLength - counts[0]];
+    if(counts[1] != 0 && counts[0] == 0)
+        return -LINE_PATTERN_WEIGHTS[winLength - counts[1]];
+    return 0;
+}
+
+// the part of patternScore and threats that comes from one line, taken out before its counts change and put back after
+static inline void updateLinePattern(LineCounts *lines, const uint8_t counts[2], int winLength, int sign){
+    lines->patternScore += sign * linePattern(counts, winLength);
+    lines->threats[0] += sign * (counts[0] == winLength - 1 && counts[1] == 0);
+    lines->threats[1] += sign * (counts[1] == winLength - 1 && counts[0] == 0);
+}
+
+/// @brief Fills table with the lines of a board. Only needed for boards that aren't presets, see presetLineTable.
+/// @param config board size and win length
+/// @param table out parameter
+void buildLineTable(BoardConfig config, LineTable *table);
+
+/// @brief Resets lines to the counts of an empty board.
+/// @param table lines of the board
+/// @param lines out parameter
+void clearLineCounts(const LineTable *table, LineCounts *lines);
+
+// opens (delta 1) or closes (delta -1) a line for every cell on it
+static inline void updateOpenLine(const LineTable *table, LineCounts *lines, int line, int delta){
+    int cell = table->lineStart[line];
+    for(int i = 0; i < table->config.winLength; i++){
+        lines->cellOpenLines[cell] += delta;
+        cell += table->lineStep[line];
+    }
+    lines->openLines += delta;
+}
+
+/// @brief Counts a piece placed on cell in every line through it, and updates the pattern score and threats of those lines.
+/// @param table lines of the board
+/// @param lines counts to update
+/// @param cell row * MAX_BOARD_SIZE + col
+/// @param side 0 for X (Cross), 1 for O (Nought)
+static inline void addLinePiece(const LineTable *table, LineCounts *lines, int cell, int side){
+    for(int i = 0; i < table->cellLineCount[cell]; i++){
+        int line = table->cellLines[cell][i];
+        uint8_t *counts = lines->counts[line];
+        updateLinePattern(lines, counts, table->config.winLength, -1);
+        // the first piece of this side in a line the other side already holds blocks it
+        if(counts[side] == 0 && counts[side ^ 1] != 0)
+            updateOpenLine(table, lines, line, -1);
+        lines->completedLines += ++counts[side] == table->config.winLength;
+        updateLinePattern(lines, counts, table->config.winLength, 1);
+    }
+}
+
+/// @brief Undoes addLinePiece.
+/// @param table lines of the board
+/// @param lines counts to update
+/// @param cell row * MAX_BOARD_SIZE + col
+/// @param side 0 for X (Cross), 1 for O (Nought)
+static inline void removeLinePiece(const LineTable *table, LineCounts *lines, int cell, int side){
+    for(int i = 0; i < table->cellLineCount[cell]; i++){
+        int line = table->cellLines[cell][i];
+        uint8_t *counts = lines->counts[line];
+        updateLinePattern(lines, counts, table->config.winLength, -1);
+        lines->completedLines -= counts[side] == table->config.winLength;
+        if(--counts[side] == 0 && counts[side ^ 1] != 0)
+            updateOpenLine(table, lines, line, 1);
+        updateLinePattern(lines, counts, table->config.winLength, 1);
+    }
+}
+
+/// @brief The whole state of one game, individual parameters are documented in the header.
+/// Owned by the caller and passed to every rule function, so any number of games can be played side by side, one per
+/// thread or thousands on one. The functions only touch the state they are given.
 typedef struct GameState{
-    int board[3][3];// 2D array for ttt board, 0 for empty, 1 for X (Cross), 2 for nought (O)
-    Node* currentMove; // head of the linked list
+    int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];// 2D array for ttt board, 0 for empty, 1 for X (Cross), 2 for nought (O). Only config.size x config.size is used.
+    BoardConfig config; // board size and number in a row needed to win
+    MoveHistory history; // every move of the game by ply, undo, redo and jumpToPly walk it without allocating
     bool player1StartFirst; // randomly initialised variable, X will always be drawn first, so this is used to determine whether or not it is AI or player that starts first.
     bool isDraw; // handle draw cases, as they are a special case.
     bool isStarted; // states if the game has started (for gui only). not required for tui since it terminates upon game termination.
@@ -15,42 +124,97 @@ typedef struct GameState{
     PlayerType turn; // 0 for player 1, 1 for player 2, -1 for AI
     PlayerType player; // Player 1 will always be a human player
     PlayerType opponent; // Player 2 can be AI or player.
+    const LineTable *lines; // lines of the current board config, shared and never owned by the state. NULL for ultimate and qubic
+    LineCounts lineCounts; // kept up to date by doMove, undo and redo. the game is won once a line is completed, and an early draw once none is open
+    int movesMade; // number of pieces on the board
 }GameState;
 
-/// @brief stores the gameState in a global variable.
-extern GameState gameState;
+// Number of entries in BOARD_PRESETS
+#define BOARD_PRESET_COUNT 4
+
+/// @brief Board sizes offered by the gui and tui: 3x3, 4x4 and 5x5 with 4 in a row, and 15x15 with 5 in a row (gomoku).
+extern const BoardConfig BOARD_PRESETS[BOARD_PRESET_COUNT];
+
+/// @brief Finds a board config among BOARD_PRESETS.
+/// @return its index, or -1 if it isn't a preset
+int boardPresetIndex(BoardConfig config);
+
+/// @brief Returns the lines of a preset board, generated at build time by tools/gen_board_tables.c.
+/// @return the table, or NULL if config isn't a preset and its table has to be built with buildLineTable
+const LineTable *presetLineTable(BoardConfig config);
+
+/// @brief Checks if the config is the classic 3x3 game, which has its own bitboard fast paths.
+bool isClassicBoard(BoardConfig config);
 
-/// @brief Creates an initializes gameState into a ready state
-extern void createGameState();
+/// @brief Initializes state into a ready state, every field is set so it can be fresh memory
+/// @param state the game, owned by the caller
+/// @param opponent PLAYER_2 or AI
+/// @param config size of the board and the number in a row needed to win
+extern void createGameState(GameState *state, PlayerType opponent, BoardConfig config);
 
-/// @brief destroys gameState to save memory, to be executed at the end by the agent.
-extern void destroyGameState();
+/// @brief Initializes state like createGameState for ultimate and qubic, whose rules live in their own modules and
+/// only copy their board into state. No line table is set up, so doMove, undo, redo, jumpToPly, checkWin and
+/// checkDraw must not be used on it.
+/// @param state the game, owned by the caller
+/// @param opponent PLAYER_2 or AI
+/// @param config size of the board the pieces are shown on
+void createMirroredGameState(GameState *state, PlayerType opponent, BoardConfig config);
+
+/// @brief Ends the game in state, to be executed at the end by the agent. Nothing is allocated, so state can be reused or freed after.
+/// @param state the game
+extern void destroyGameState(GameState *state);
 
 /// @brief Executes the current player move in column and row
-/// @param col column of the move
+/// @param state the game
 /// @param row row of the move
+/// @param col column of the move
 /// @return returns true if successful, false if disallowed.
-bool doMove(int col, int row);
+bool doMove(GameState *state, int row, int col);
+
+/// @brief Checks if the piece at row, col is part of winLength in a row.
+/// Only the 4 lines through that cell are walked, so it costs O(winLength) regardless of the board size.
+/// @param board the board
+/// @param config board size and win length
+/// @param row row of the last move
+/// @param col column of the last move
+/// @return true if the move at row, col won the game
+bool isWinningMove(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int row, int col);
 
 /// @brief Checks if the game has been won on any win condition
+/// Constant time, doMove, undo and redo keep count of the completed lines.
+/// @param state the game
 /// @return 
-bool checkWin();
+bool checkWin(const GameState *state);
 
 /// @brief Checks if the game has no possible ways of winning
+/// Constant time, doMove, undo and redo keep count of the lines that are still open.
+/// @param state the game
 /// @return 
-bool checkDraw();
+bool checkDraw(GameState *state);
 
-/// @brief Checks for win and draw conditions and updates GameState Accordingly
+/// @brief Checks for win and draw conditions and updates state Accordingly
+/// @param state the game
 /// @return 
-void nextTurn();
+void nextTurn(GameState *state);
 
 /// @brief Checks if there are possible moves left, return true, otherwise, return false
+/// @param board the board
+/// @param config board size
 /// @return 
-bool isMovesLeft();
+bool isMovesLeft(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config);
+
+/// @brief Steps back in the move history, in order to undo a previous turn. Resets state automatically and prevents repeated turns.
+/// @param state the game
+void undo(GameState *state);
 
-/// @brief Traverses backwards in the linked list, in order to undo a previous turn. Resets gameState automatically and prevents repeated turns.
-void undo();
+/// @brief Steps forwards in the move history, in order to redo a previous turn. Resets state automatically and prevents repeated turns.
+/// @param state the game
+void redo(GameState *state);
 
-/// @brief Traverses forwards in the linked list, in order to redo a previous turn. Resets gameState automatically and prevents repeated turns.
-void redo();
+/// @brief Takes back or replays moves until ply moves are on the board, for replays and self-play.
+/// Unlike undo and redo it stops at any ply, whoever's turn it is, and costs one board update per move in between.
+/// @param state the game
+/// @param ply number of moves to keep, from 0 for the empty board up to the number of moves recorded
+/// @return false if ply is out of that range
+bool jumpToPly(GameState *state, int ply);
 #endif
\ No newline at end of file
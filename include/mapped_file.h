@@ -0,0 +1,28 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/// @brief A file mapped read-only into memory. Nothing is read up front,
+/// the operating system loads each page the first time it is touched.
+typedef struct MappedFile{
+    const void *data; // the whole file
+    size_t size;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+}MappedFile;
+
+/// @brief Maps a file read-only, with mmap or MapViewOfFile on windows.
+/// The mapping is set up for random access, read ahead would only load pages that are never looked at.
+/// @param path the file
+/// @param file out parameter, the mapping
+/// @return false if the file doesn't exist, is empty or can't be mapped
+bool mapFile(const char *path, MappedFile *file);
+
+/// @brief Unmaps a file mapped by mapFile.
+void unmapFile(MappedFile *file);
+
+#endif
@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdatomic.h>
+#include <util.h>
+#include <game.h>
+#include <minimax.h>
+
+#ifndef MCTS_H
+#define MCTS_H
+
+// Number of tree nodes the arena holds, allocated once on first use. Once it is full the tree stops growing
+// and the remaining playouts start from its leaves.
+#define MCTS_ARENA_SIZE (1 << 20)
+
+// Exploration constant of UCT, sqrt(2) is the textbook value for results between 0 and 1.
+#define MCTS_EXPLORATION 1.41421356f
+
+// Playouts on "Easy", a limit of 0 means only the time budget counts.
+#define MCTS_EASY_PLAYOUTS 500
+
+/// @brief One node of the search tree, all of them live in a single arena and refer to each other by index.
+typedef struct MctsNode{
+    int parent; // index of the parent, -1 for the root
+    int firstChild; // index of the first child, the children are stored next to each other. -1 until expanded.
+    int16_t childCount;
+    int16_t cell; // move that led here, row * size + col
+    int8_t piece; // BOARD_CROSS or BOARD_NOUGHT, whoever played cell
+    int8_t outcome; // 0 if the game goes on, 1 if cell won the game, 2 if it filled the board
+    int visits;
+    float wins; // sum of the playout results for piece, 1 for a win and 0.5 for a draw
+}MctsNode;
+
+/// @brief Settings and memory of one Monte Carlo search, like SearchContext for minimax.
+/// Searches with different contexts can run at once on different threads.
+typedef struct MctsContext{
+    int playouts; // maximum number of playouts per move, 0 for no limit. Set by tui.c and gui.c from the difficulty.
+    int budgetMs; // time allowed per move in milliseconds, the search stops at whichever of the two limits comes first
+    SearchStats stats; // what the last search cost, nodes counts the playouts and maxDepth the deepest tree node
+    atomic_bool cancelled; // set to stop a running search, it then returns the best move so far
+    MctsNode *arena; // MCTS_ARENA_SIZE nodes, allocated on first use
+    int arenaUsed;
+    uint64_t rngState; // xorshift64 state, seeded from the clock on first use
+}MctsContext;
+
+/// @brief Creates a Monte Carlo search context.
+/// @param playouts maximum number of playouts per move, 0 for no limit
+/// @param budgetMs time allowed per move in milliseconds
+/// @return the new context, terminates the program if memory allocation fails
+MctsContext *createMctsContext(int playouts, int budgetMs);
+
+/// @brief Frees the context and its node arena.
+void destroyMctsContext(MctsContext *context);
+
+/// @brief Finds a move with Monte Carlo Tree Search (UCT). Every iteration walks down the tree picking the child
+/// with the best upper confidence bound, expands the leaf, plays random moves until the game ends and records the
+/// result on the way back up. Needs no evaluation function, so it plays any board size.
+/// @param context limits and memory of the search, stats is updated
+/// @param board The tic-tac-toe board.
+/// @param config board size and number in a row needed to win
+/// @param currentPlayer unused, for compatibility with findBestMove
+/// @param playerStartFirst true if player 1 is X (Cross), the AI plays the other piece
+/// @return the most visited move, (-1, -1) if the board is full
+Pair findBestMCTSMove(MctsContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType currentPlayer, bool playerStartFirst);
+
+#endif
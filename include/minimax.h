@@ -1,6 +1,10 @@
 #include <stdbool.h>
 #include <math.h>
+#include <stdatomic.h>
 #include <util.h>
+#include <bitboard.h>
+#include <transposition.h>
+#include <thread_pool.h>
 
 #ifndef MM_H
 #define MM_H
@@ -13,25 +17,122 @@ typedef struct Pair {
 } Pair;
 
 /// @brief Checks the board and returns a score.
-/// @param board The tic-tac-toe board.
+/// @param board The tic-tac-toe board as a bitboard.
 /// @return 10 if AI wins -10 if player wins, 0 otherwise
-int evaluateBoard(int board[3][3]);
+int evaluateBoard(Bitboard board);
 
-/// @brief The minimax function (recursive).
-/// @param board The tic-tac-toe board.
+// Time allowed per move by findBestMove on the "Impossible" difficulty for boards that can't be searched to the end.
+#define DEFAULT_MOVE_BUDGET_MS 1000
+
+// Deepest search on the classic board, a depth this high covers the whole game ("Impossible").
+#define CLASSIC_MAX_DEPTH 9
+
+// On boards larger than this only cells within NEIGHBOUR_RADIUS of a piece are searched, like gomoku engines do,
+// a move far away from everything is never better than one next to the action. Every engine and tool that has to
+// consider the same moves as the search uses these.
+#define FULL_WIDTH_MAX_SIZE 5
+#define NEIGHBOUR_RADIUS 2
+
+struct BoardSearch;
+struct LineTable;
+struct OpeningBook;
+struct SolvedDatabase;
+
+/// @brief Everything one search needs besides the board: settings, counters and the memory it works in.
+/// Searches with different contexts share nothing, so any number of them can run at once on different threads,
+/// one context must only be used by one search at a time.
+typedef struct SearchContext{
+    int maxDepth; // how many moves ahead minimax looks, affects difficulty
+    int threads; // threads searching boards other than the classic 3x3, 1 searches on the calling thread only
+    SearchStats stats; // what the last search cost, see SearchStats
+    atomic_bool cancelled; // set by cancelSearch, a search that sees it returns as soon as possible
+    int previousBest[CLASSIC_MAX_DEPTH + 2]; // best cell of the last node searched at each depth, see minimax
+    TranspositionTable *table; // positions of the classic game under their symmetry-canonical form, created on first use
+    SharedTranspositionTable *sharedTable; // lock-free table shared by the search threads on other boards, created on first use
+    ThreadPool *pool; // threads splitting the root moves, (re)created when threads changes
+    struct BoardSearch *threadSearches; // one copy of the board search per thread
+    struct LineTable *lines; // lines of the last board searched that isn't a preset, rebuilt when the board changes
+    const struct OpeningBook *book; // answers known openings of boards other than 3x3 without searching, NULL for none, not owned
+    const struct SolvedDatabase *database; // answers every position of its board without searching, NULL for none, not owned
+}SearchContext;
+
+/// @brief Creates a search context, the transposition tables, line table and threads are only allocated once a search needs them.
+/// @param maxDepth how many moves ahead minimax looks
+/// @param threads number of threads searching boards other than 3x3, cpuCount() uses every core
+/// @return the new context, terminates the program if memory allocation fails
+SearchContext *createSearchContext(int maxDepth, int threads);
+
+/// @brief Stops the context's threads and frees it with its transposition tables.
+void destroySearchContext(SearchContext *context);
+
+/// @brief Asks a search running on another thread to stop, safe to call from any thread.
+/// The flag stays set, so later searches with the context return straight away until resetSearchCancel is called.
+void cancelSearch(SearchContext *context);
+
+/// @brief Clears the flag set by cancelSearch so the context can search again.
+void resetSearchCancel(SearchContext *context);
+
+/// @brief The context's thread pool with context->threads threads, for engines of other games that split their
+/// root moves like the board search does. Rebuilt when the setting changed since the last search.
+ThreadPool *searchThreadPool(SearchContext *context);
+
+/// @brief Adds the counters of one search thread to the totals, the depth is the deepest of the two.
+void addSearchStats(SearchStats *total, const SearchStats *stats);
+
+/// @brief The minimax function (recursive) with alpha-beta pruning and a transposition table.
+/// Moves are tried hash move first, then the best cell of the previous sibling, then center, corners and edges.
+/// Positions at context->maxDepth are scored by the lines each side holds instead of as a draw.
+/// @param context depth limit, node counter and transposition table of the search
+/// @param board The tic-tac-toe board as a bitboard with the AI's pieces as crosses, passed by value so nothing has to be undone.
 /// @param depth How deep we are in the search
+/// @param alpha The score the maximizing player is already assured of, start with -1000
+/// @param beta The score the minimizing player is already assured of, start with 1000
 /// @param isMaximizing True if it's the AI's turn, false if it's the player's turn.
-/// @return The best score the current player can get
-int minimax(int board[3][3], int depth, bool isMaximizing, PlayerType currentPlayer);
+/// @param currentPlayer the side to move, the AI places crosses and PLAYER_1 noughts
+/// @return The best score the current player can get, a win is worth 12 per move left before the 10th
+int minimax(SearchContext *context, Bitboard board, int depth, int alpha, int beta, bool isMaximizing, PlayerType currentPlayer);
+
+/// @brief Looks up the perfect-play move in the precomputed MOVE_TABLE, constant time and no recursion.
+/// @param board The tic-tac-toe board.
+/// @param currentPlayer unused, for compatibility with findBestMove
+/// @param playerStartFirst unused, for compatibility with findBestMove
+/// @return The optimal move for whoever's turn it is, (-1, -1) if the game is over.
+Pair findTableMove(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], PlayerType currentPlayer, bool playerStartFirst);
 
 /// @brief Figures out the best move using minimax AI.
+/// The classic 3x3 game is searched on bitboards, and when context->maxDepth covers the whole game ("Impossible")
+/// the answer comes from findTableMove instead. Any other board is searched on the int array with incrementally kept
+/// line counts, which tell wins and dead draws in constant time and score the horizon by the open lines of each side.
+/// On "Impossible" it gets DEFAULT_MOVE_BUDGET_MS with findBestMoveTimed.
+/// @param context settings and memory of the search, stats is updated
 /// @param board The tic-tac-toe board.
-/// @return The best move the minimax AI can make.
-Pair findBestMove(int board[3][3], PlayerType currentPlayer, bool playerStartFirst);
+/// @param config board size and number in a row needed to win
+/// @return The best move the minimax AI can make, (-1, -1) if the search was cancelled before finding one.
+Pair findBestMove(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType currentPlayer, bool playerStartFirst);
+
+/// @brief Finds the best move and its minimax value for the given side, searching exactly context->maxDepth moves ahead.
+/// Unlike findBestMove it never answers from the move table or stops on the clock, so results only depend on the position
+/// and the depth, which is what offline analysis wants. See solvePositions for many positions at once.
+/// @param context settings and memory of the search, stats is updated
+/// @param board The tic-tac-toe board, left unchanged.
+/// @param config board size and number in a row needed to win
+/// @param toMove BOARD_CROSS or BOARD_NOUGHT, the side to find a move for
+/// @param value out parameter, score of the move for toMove: > 0 wins, < 0 loses, 0 draws or is undecided within the depth.
+/// A win scores 1000 minus the number of moves played after this one before it happens.
+/// @return the best move, (-1, -1) with a value of 0 if the game is already over.
+Pair solvePosition(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int toMove, int *value);
 
-/// @brief Checks if there are any empty spots left on the board
+/// @brief Searches with iterative deepening until the time budget runs out, for a predictable reply time on any board.
+/// Each depth starts with the best move of the previous one, and the move of the last depth that finished is returned.
+/// The classic 3x3 game answers from findTableMove straight away, the board of context->database from the database
+/// and other boards from context->book when the position is in it.
+/// @param context settings and memory of the search, maxDepth is ignored and stats is updated
 /// @param board The tic-tac-toe board.
-/// @return True if there are empty spots, false otherwise
-bool isMovesLeft(int board[3][3]);
+/// @param config board size and number in a row needed to win
+/// @param currentPlayer the player to find a move for
+/// @param playerStartFirst true if player 1 is X (Cross)
+/// @param budgetMs time allowed for the search in milliseconds
+/// @return The best move found in time or before being cancelled, (-1, -1) if the board is full.
+Pair findBestMoveTimed(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType currentPlayer, bool playerStartFirst, int budgetMs);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,45 @@
+#include <stdint.h>
+#include <util.h>
+
+#ifndef MOVE_HISTORY_H
+#define MOVE_HISTORY_H
+
+// Every move takes a cell, so no line of play is longer than the largest board has cells.
+#define MAX_GAME_MOVES (MAX_BOARD_SIZE * MAX_BOARD_SIZE)
+
+/// @brief One move of a game.
+typedef struct MoveRecord{
+    int8_t player; // PlayerType of whoever made the move
+    uint8_t row;
+    uint8_t col;
+}MoveRecord;
+
+/// @brief Moves of a game in the order they were played, in a fixed array indexed by ply so it never allocates.
+/// Undo and redo only move current, the moves from current on stay recorded until a new move replaces them.
+typedef struct MoveHistory{
+    MoveRecord moves[MAX_GAME_MOVES]; // moves[ply] is the move made at ply, counting from 0
+    int current; // moves on the board, moves[current - 1] is the last one played
+    int count; // moves recorded, the ones from current up to count can be redone
+}MoveHistory;
+
+/// @brief Forgets every move.
+static inline void clearMoveHistory(MoveHistory *history){
+    history->current = 0;
+    history->count = 0;
+}
+
+/// @brief Records a move after the current one, dropping whatever could have been redone.
+static inline void pushMove(MoveHistory *history, PlayerType player, int row, int col){
+    MoveRecord *move = &history->moves[history->current++];
+    move->player = (int8_t)player;
+    move->row = (uint8_t)row;
+    move->col = (uint8_t)col;
+    history->count = history->current;
+}
+
+/// @brief Returns the move made at ply, which has to be below history->count.
+static inline const MoveRecord *moveAt(const MoveHistory *history, int ply){
+    return &history->moves[ply];
+}
+
+#endif
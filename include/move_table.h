@@ -0,0 +1,29 @@
+#include <stdint.h>
+#include <bitboard.h>
+
+#ifndef MOVE_TABLE_H
+#define MOVE_TABLE_H
+
+// Number of base-3 board encodings, 3^9. Most of them are unreachable, but indexing every one keeps the lookup O(1).
+#define MOVE_TABLE_SIZE 19683
+
+/// @brief Perfect-play result for one position, from the point of view of the side to move.
+/// X (Cross) always moves first, so the side to move follows from the piece counts.
+typedef struct MoveTableEntry{
+    int8_t move; // best cell (row * 3 + col), -1 if the game is over or the position is unreachable
+    int8_t value; // 10 - plies until the win, 0 for a draw, negative if the side to move loses
+}MoveTableEntry;
+
+/// @brief Optimal move and value of every position, indexed by positionIndex.
+/// Generated at build time by tools/gen_move_table.c, which solves the whole game once.
+extern const MoveTableEntry MOVE_TABLE[MOVE_TABLE_SIZE];
+
+/// @brief BASE3_OF_MASK[mask] is the base-3 number with a 1 digit for every set bit of mask, generated with MOVE_TABLE.
+extern const uint16_t BASE3_OF_MASK[512];
+
+/// @brief Returns the MOVE_TABLE index of a position, digit (row * 3 + col) is the value of that cell.
+static inline int positionIndex(Bitboard board){
+    return BASE3_OF_MASK[board.cross] + 2 * BASE3_OF_MASK[board.nought];
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <util.h>
+#include <minimax.h>
+#include <mapped_file.h>
+
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+// File the gui and tui load the book from, relative to the working directory like weights/. Built by ttt-book.
+#define OPENING_BOOK_PATH "opening_book.bin"
+
+// First 8 bytes of every book file
+#define OPENING_BOOK_MAGIC "TTTBOOK"
+// Bumped whenever BookEntry or openingBookKey change, older files are refused
+#define OPENING_BOOK_VERSION 1
+
+/// @brief Start of a book file, followed by entryCount BookEntry sorted by key.
+/// Everything is stored in the byte order of the machine that built it, books aren't meant to be shared across architectures.
+typedef struct BookHeader{
+    char magic[8]; // OPENING_BOOK_MAGIC, null terminated
+    uint32_t version; // OPENING_BOOK_VERSION
+    uint32_t entrySize; // sizeof(BookEntry), catches books written by a build with a different layout
+    uint64_t entryCount;
+}BookHeader;
+
+/// @brief Best move of one position. All 8 rotations and reflections of a position share an entry,
+/// the move is stored for the orientation openingBookKey picks and mapped back when the book is probed.
+typedef struct BookEntry{
+    uint64_t key; // openingBookKey of the position
+    int16_t value; // solvePosition score of the move for the side to move
+    uint8_t cell; // best move in the canonical orientation, row * size + col
+    uint8_t size; // board the position is on, a book can hold several
+    uint8_t winLength;
+    uint8_t depth; // depth the move was searched to
+    uint8_t reserved[2]; // keeps the entry at 16 bytes
+}BookEntry;
+
+/// @brief An opening book mapped into memory. Only the header is read when it is opened,
+/// the pages holding entries are loaded by the operating system the first time a probe touches them.
+typedef struct OpeningBook{
+    const BookEntry *entries; // sorted by key, points into the mapping
+    size_t entryCount;
+    MappedFile file;
+}OpeningBook;
+
+/// @brief Symmetry-canonical key of a position on a given board, the side to move follows from the piece counts.
+/// @param board the board
+/// @param config board size and win length, part of the key so one book can hold several boards
+/// @param symmetry out parameter, the rotation or reflection (see SYMMETRY_CELLS) that maps board onto the canonical orientation
+/// @return the smallest Zobrist key of the 8 orientations of the position
+uint64_t openingBookKey(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int *symmetry);
+
+/// @brief Applies one of the 8 symmetries of a square board to a cell, same numbering as SYMMETRY_CELLS.
+/// @param cell row * size + col
+/// @param size number of rows and columns
+/// @param symmetry index of the rotation or reflection
+/// @return the cell it ends up on, row * size + col
+int transformBookCell(int cell, int size, int symmetry);
+
+/// @brief Maps a book file into memory.
+/// @param path the file written by ttt-book
+/// @return the book, NULL if the file doesn't exist or isn't a valid book
+OpeningBook *openOpeningBook(const char *path);
+
+/// @brief Unmaps and frees a book, NULL is ignored.
+void closeOpeningBook(OpeningBook *book);
+
+/// @brief Looks up the best move of a position.
+/// @param book the book, NULL finds nothing
+/// @param board the board
+/// @param config board size and win length
+/// @param move out parameter, the move for the side to move
+/// @param value out parameter, its score like solvePosition's, may be NULL
+/// @return true if the position is in the book
+bool probeOpeningBook(const OpeningBook *book, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, Pair *move, int *value);
+
+#endif
@@ -0,0 +1,61 @@
+#include <pthread.h>
+#include <util.h>
+#include <minimax.h>
+
+#ifndef PONDER_H
+#define PONDER_H
+
+// Depth of the search that guesses the human's reply, which is pondered first
+#define PONDER_PREDICTION_DEPTH 4
+
+/// @brief Searches the AI's answers to the likely human replies on a background thread while the human thinks.
+/// The predicted reply goes first, then the others nearest the pieces already placed, each with the full move budget.
+/// The ponder thread borrows the caller's search context, so the caller must not search with it in between
+/// startPondering and ponderHit or stopPondering. Every search starts a new transposition table generation, so after a
+/// miss the real reply is searched from scratch.
+typedef struct Ponder{
+    SearchContext *context; // shared with the caller, not owned
+    pthread_t thread;
+    bool running; // the thread was started and hasn't been joined yet
+    int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; // position the human is to move in
+    BoardConfig config;
+    PlayerType aiPlayer;
+    bool playerStartFirst;
+    int humanPiece; // BOARD_CROSS or BOARD_NOUGHT
+    // answers found so far, only written by the ponder thread and only read once it is joined
+    int answerCount;
+    int replies[MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // human reply, row * size + col
+    Pair answers[MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // the AI's move after it
+    SearchStats answerStats[MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // what finding it cost
+}Ponder;
+
+/// @brief Creates a ponderer that searches with the given context, nothing runs until startPondering.
+/// @param context search context of the AI, it keeps its settings, book and database
+/// @return the ponderer, terminates the program if memory allocation fails
+Ponder *createPonder(SearchContext *context);
+
+/// @brief Stops pondering and frees the ponderer, NULL is ignored.
+void destroyPonder(Ponder *ponder);
+
+/// @brief Starts searching the AI's answers to the human's replies in the background, stopping any earlier pondering.
+/// Every answer is a findBestMoveTimed search, so only worth it on boards where the AI searches against the clock.
+/// @param ponder the ponderer
+/// @param board the position with the human to move, copied
+/// @param config board size and win length
+/// @param aiPlayer the AI's player, as passed to findBestMove
+/// @param playerStartFirst as passed to findBestMove
+void startPondering(Ponder *ponder, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType aiPlayer, bool playerStartFirst);
+
+/// @brief Stops pondering and looks up the answer to the move the human made. The cache is emptied either way,
+/// and the context is free for the caller again when this returns.
+/// @param ponder the ponderer
+/// @param board the position after the human's move
+/// @param move out parameter, the AI's move on a hit
+/// @return true on a ponder hit, context->stats is then set to the stats of the pondered search
+bool ponderHit(Ponder *ponder, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Pair *move);
+
+/// @brief Stops the ponder thread and throws its answers away, for undo, restart or a change of settings.
+/// Returns once the thread is joined, so the context is free for the caller again.
+void stopPondering(Ponder *ponder);
+
+#endif
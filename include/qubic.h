@@ -0,0 +1,124 @@
+#include <stdint.h>
+#include <util.h>
+#include <board_tables.h>
+#include <game.h>
+
+#ifndef QUBIC_H
+#define QUBIC_H
+
+// Qubic: tic-tac-toe on a 4x4x4 cube, four in a row along any of the 76 lines of the cube wins. The gui draws
+// the four layers as a 2x2 grid of 4x4 boards, so the cube fits the MAX_BOARD_SIZE board of GameState.
+
+// Cells of the cube, numbered layer * 16 + row * 4 + col, bit cell of a QubicBoard mask
+#define QUBIC_CELLS 64
+// Winning lines: 48 rows and columns, 16 pillars through the layers, 8 diagonals inside the layers,
+// 16 diagonals across them and the 4 diagonals through the center of the cube
+#define QUBIC_LINE_COUNT 76
+// Most lines through one cell, the 8 corners and 8 center cells lie on 7
+#define QUBIC_MAX_CELL_LINES 7
+// Rows and columns of the grid the gui draws, the layers laid out 2x2
+#define QUBIC_GRID_SIZE 8
+
+/// @brief Complete position of a qubic game, one 64 bit mask per side.
+typedef struct QubicBoard{
+    uint64_t cross;
+    uint64_t nought;
+    int8_t toMove; // BOARD_CROSS or BOARD_NOUGHT
+    int8_t winner; // BOARD_EMPTY while the game goes on, BOARD_CROSS, BOARD_NOUGHT, or QUBIC_DRAW once the cube is full
+    uint8_t movesMade;
+}QubicBoard;
+
+// Value of QubicBoard.winner when the cube filled up without four in a row
+#define QUBIC_DRAW 3
+
+// QUBIC_LINES, the 76 lines as masks of their 4 cells, and QUBIC_CELL_LINE_COUNT / QUBIC_CELL_LINES, the lines through
+// every cell, come from board_tables.h, generated at build time by tools/gen_board_tables.c.
+
+/// @brief Every position of one game, for undo and redo without replaying moves.
+typedef struct QubicGame{
+    QubicBoard positions[QUBIC_CELLS + 1]; // positions[i] is the board after i moves
+    int current; // moves played, positions[current] is on the board
+    int last; // moves that can be redone up to
+}QubicGame;
+
+/// @brief Number of set bits of a mask, the pieces on a line or the cells of a threat mask.
+static inline int countCells(uint64_t mask){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(mask);
+#else
+    int count = 0;
+    for(; mask != 0; mask &= mask - 1)
+        count++;
+    return count;
+#endif
+}
+
+/// @brief Index of the lowest set bit of a non-zero mask.
+static inline int lowestQubicCell(uint64_t mask){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int cell = 0;
+    while((mask & 1) == 0){
+        mask >>= 1;
+        cell++;
+    }
+    return cell;
+#endif
+}
+
+/// @brief Sets up the empty cube, X to move.
+void initQubicBoard(QubicBoard *board);
+
+/// @brief Empty cells of the cube, 0 once the game is over.
+static inline uint64_t qubicEmptyCells(const QubicBoard *board){
+    return board->winner != BOARD_EMPTY ? 0 : ~(board->cross | board->nought);
+}
+
+/// @brief Plays a move for the side to move on an empty cell and updates the winner.
+/// Only the at most 7 lines through the cell are checked.
+void playQubicMove(QubicBoard *board, int cell);
+
+/// @brief Threats of one side: empty cells that complete a line holding 3 of its pieces and none of the other side's.
+/// @param mine pieces of the side the threats belong to
+/// @param theirs pieces of the other side
+/// @return mask of the cells, more than one bit set can't be blocked anymore
+uint64_t qubicThreats(uint64_t mine, uint64_t theirs);
+
+/// @brief Converts a row and column of the 8x8 grid the gui draws into a cell of the cube.
+static inline int qubicMoveAt(int row, int col){
+    return (row / 4 * 2 + col / 4) * 16 + (row % 4) * 4 + col % 4;
+}
+
+/// @brief Row of the 8x8 grid a cell is drawn on.
+static inline int qubicMoveRow(int cell){
+    return cell / 32 * 4 + cell % 16 / 4;
+}
+
+/// @brief Column of the 8x8 grid a cell is drawn on.
+static inline int qubicMoveCol(int cell){
+    return cell / 16 % 2 * 4 + cell % 4;
+}
+
+/// @brief Starts a new game on the empty cube.
+void newQubicGame(QubicGame *game);
+
+/// @brief Position currently on the board.
+static inline QubicBoard *qubicGameBoard(QubicGame *game){
+    return &game->positions[game->current];
+}
+
+/// @brief Plays a move and forgets the moves that could have been redone.
+/// @return false if the cell is taken or the game is over, nothing changes then
+bool playQubicGameMove(QubicGame *game, int cell);
+
+/// @brief Copies the pieces, the turn and the result of the position into state, like syncUltimateGameState.
+void syncQubicGameState(GameState *state, const QubicBoard *board);
+
+/// @brief Undo button of the gui: takes back moves like undoUltimateTurn and syncs state.
+void undoQubicTurn(GameState *state, QubicGame *game);
+
+/// @brief Redo button of the gui: plays moves taken back again like redoUltimateTurn and syncs state.
+void redoQubicTurn(GameState *state, QubicGame *game);
+
+#endif
@@ -0,0 +1,28 @@
+#include <util.h>
+#include <minimax.h>
+#include <qubic.h>
+
+#ifndef QUBIC_SEARCH_H
+#define QUBIC_SEARCH_H
+
+// Score of a won game for the winner, minus the moves it takes. Fits the 16 bit values of the shared table.
+#define QUBIC_WIN_SCORE 10000
+
+/// @brief Finds a move for the side to move on the cube.
+/// Alpha-beta over the context's threads and shared transposition table, like the search of the larger boards.
+/// Threats are found with a popcount per line: a threat of the side to move wins at once, two of the opponent's
+/// lose, and one has to be blocked, which is searched without using up depth.
+/// A context->maxDepth below CLASSIC_MAX_DEPTH ("Easy") searches exactly that many moves ahead. Anything deeper
+/// deepens one move at a time until budgetMs runs out and plays the move of the last depth that finished.
+/// @param context settings and memory of the search, stats is updated
+/// @param board the position, left unchanged
+/// @param budgetMs time budget for the timed search, see DEFAULT_MOVE_BUDGET_MS
+/// @return row and column of the move on the 8x8 grid, (-1, -1) if the game is over
+Pair findBestQubicMove(SearchContext *context, const QubicBoard *board, int budgetMs);
+
+/// @brief Evaluation of a position the search doesn't look past: lines only one side holds pieces on, weighted by
+/// how many it holds.
+/// @return score for the side to move, positive is good for it
+int evaluateQubicBoard(const QubicBoard *board);
+
+#endif
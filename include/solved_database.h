@@ -0,0 +1,90 @@
+#include <stdint.h>
+#include <stdatomic.h>
+#include <util.h>
+#include <minimax.h>
+#include <mapped_file.h>
+
+#ifndef SOLVED_DATABASE_H
+#define SOLVED_DATABASE_H
+
+// First 8 bytes of every database file
+#define SOLVED_DATABASE_MAGIC "TTTSOLV"
+// Bumped whenever the layout or the position index change, older files are refused
+#define SOLVED_DATABASE_VERSION 1
+// 3^16 positions take 10.8 MB at 2 bits each, 5x5 would need 3^25 and over 200 GB
+#define SOLVED_DATABASE_MAX_CELLS 16
+
+// Result of a position for the side to move, 2 bits each in the database
+#define SOLVED_UNKNOWN 0 // not a legal position, never written
+#define SOLVED_LOSS 1
+#define SOLVED_DRAW 2
+#define SOLVED_WIN 3
+
+/// @brief Start of a database file, followed by positionCount results packed 4 to a byte, lowest bits first.
+/// A position's index is sum(board[row][col] * 3^(row * size + col)), so every board of the size has a slot.
+/// The side to move follows from the piece counts, X moves when they are equal.
+typedef struct SolvedHeader{
+    char magic[8]; // SOLVED_DATABASE_MAGIC, null terminated
+    uint32_t version; // SOLVED_DATABASE_VERSION
+    uint8_t size;
+    uint8_t winLength;
+    uint8_t reserved[2];
+    uint64_t positionCount; // 3^(size * size)
+}SolvedHeader;
+
+/// @brief Every position of one board with its perfect-play result, mapped into memory.
+/// Only the header is read when it is opened, probes load the pages they touch.
+typedef struct SolvedDatabase{
+    BoardConfig config;
+    const uint8_t *results; // points into the mapping
+    uint64_t positionCount;
+    MappedFile file;
+}SolvedDatabase;
+
+/// @brief Name of the database of a board, like "solved_4x4_4.bin". The gui and tui look for it in the working directory.
+/// @param config the board
+/// @param buffer filled with the name
+/// @param size size of buffer
+void solvedDatabasePath(BoardConfig config, char *buffer, size_t size);
+
+/// @brief Index of a position in the database, see SolvedHeader.
+uint64_t solvedPositionIndex(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config);
+
+/// @brief Reads one result out of a packed array.
+/// @param results 4 results per byte, lowest bits first
+/// @param index position index
+/// @return SOLVED_UNKNOWN, SOLVED_LOSS, SOLVED_DRAW or SOLVED_WIN for the side to move
+static inline int solvedResult(const uint8_t *results, uint64_t index){
+    return (results[index >> 2] >> ((index & 3) * 2)) & 3;
+}
+
+/// @brief Same as solvedResult for an array other threads are writing to, the solver uses it while it fills the database.
+static inline int solvedResultAtomic(const _Atomic uint8_t *results, uint64_t index){
+    return (atomic_load_explicit(&results[index >> 2], memory_order_relaxed) >> ((index & 3) * 2)) & 3;
+}
+
+/// @brief Maps a database file written by ttt-retrograde into memory.
+/// @param path the file
+/// @return the database, NULL if the file doesn't exist or isn't a valid database
+SolvedDatabase *openSolvedDatabase(const char *path);
+
+/// @brief Opens the database of the first board in BOARD_PRESETS that has one in the working directory.
+/// Of the presets only 4x4 is small enough to solve, 3x3 already has the move table.
+/// @return the database, NULL if there is none
+SolvedDatabase *openPresetDatabase();
+
+/// @brief Unmaps and frees a database, NULL is ignored.
+void closeSolvedDatabase(SolvedDatabase *database);
+
+/// @brief Picks a perfect-play move by looking up the result of every reply, no search involved.
+/// The database has no distances, so among equal results it plays an immediate win first and,
+/// when every move loses, one that doesn't let the opponent win on the next move if there is one.
+/// @param database the database, NULL or one of another board finds nothing
+/// @param board the board
+/// @param config board size and win length
+/// @param move out parameter, the move for the side to move
+/// @param value out parameter, 1 if the move wins, 0 if it draws and -1 if it loses under perfect play, may be NULL
+/// @return true if the database covers the position and it isn't over
+bool probeSolvedDatabase(const SolvedDatabase *database, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, Pair *move, int *value);
+
+#endif
@@ -0,0 +1,39 @@
+#include <pthread.h>
+#include <util.h>
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/// @brief Work run on every thread of the pool.
+/// @param arg the argument given to runThreadPool
+/// @param threadIndex 0 for the calling thread, 1 to threadCount - 1 for the workers
+typedef void (*ThreadPoolTask)(void *arg, int threadIndex);
+
+/// @brief Fixed set of worker threads that sleep until runThreadPool hands them a task.
+/// Keeping the threads alive avoids creating and joining threads on every AI move.
+typedef struct ThreadPool{
+    int threadCount; // including the calling thread, so threadCount - 1 workers are started
+    pthread_t *workers;
+    pthread_mutex_t lock;
+    pthread_cond_t taskReady; // signalled when a new task is posted or the pool shuts down
+    pthread_cond_t taskDone; // signalled when the last worker finishes the task
+    ThreadPoolTask task;
+    void *arg;
+    unsigned long generation; // bumped for every task so a worker never runs the same task twice
+    int running; // number of workers still busy with the current task
+    bool shutdown;
+}ThreadPool;
+
+/// @brief Starts a thread pool.
+/// @param threadCount total number of threads working on a task, including the one calling runThreadPool
+/// @return the pool, terminates the program if the threads can't be created
+ThreadPool *createThreadPool(int threadCount);
+
+/// @brief Runs task once on every thread of the pool and waits for all of them to return.
+/// Index 0 runs on the calling thread. Only one thread may call this on a pool at a time.
+void runThreadPool(ThreadPool *pool, ThreadPoolTask task, void *arg);
+
+/// @brief Stops and joins the workers and frees the pool.
+void destroyThreadPool(ThreadPool *pool);
+
+#endif
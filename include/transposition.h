@@ -0,0 +1,124 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <util.h>
+
+#ifndef TT_H
+#define TT_H
+
+// Default number of entries in the transposition table, can be overridden at configure time with
+// meson configure -Dtransposition_table_size=N. Rounded up to a power of two when the table is created.
+#ifndef TRANSPOSITION_TABLE_SIZE
+#define TRANSPOSITION_TABLE_SIZE 4096
+#endif
+
+// Default number of entries in the table shared by the search threads on larger boards, see
+// meson configure -Dshared_transposition_table_size=N. 16 bytes per entry.
+#ifndef SHARED_TRANSPOSITION_TABLE_SIZE
+#define SHARED_TRANSPOSITION_TABLE_SIZE (1 << 20)
+#endif
+
+/// @brief How the stored value relates to the real minimax value of the position.
+/// Alpha-beta only gets exact values inside the window, cutoffs only give a bound.
+typedef enum BoundType{
+    BOUND_EXACT = 0, // value is the minimax value
+    BOUND_LOWER = 1, // the search failed high, the real value is >= value
+    BOUND_UPPER = 2  // the search failed low, the real value is <= value
+}BoundType;
+
+/// @brief A single cached search result, packed into 8 bytes.
+typedef struct TTEntry{
+    uint32_t key; // full position key, so a hit is never a collision
+    int8_t value; // score found by minimax
+    uint8_t bound; // BoundType of value
+    int8_t bestCell; // best move found, in the coordinates of the stored position. -1 if none.
+    uint8_t generation; // search the entry belongs to, entries of older searches are treated as empty
+}TTEntry;
+
+/// @brief Fixed size, always-replace hash table of search results.
+typedef struct TranspositionTable{
+    TTEntry *entries;
+    size_t size; // number of entries, a power of two
+    uint8_t generation;
+    unsigned long long probes; // number of lookups since the last newSearchGeneration
+    unsigned long long hits; // number of lookups that found the position
+}TranspositionTable;
+
+/// @brief Allocates a transposition table.
+/// @param size requested number of entries, rounded up to a power of two
+/// @return the new table, terminates the program if memory allocation fails
+TranspositionTable *createTranspositionTable(size_t size);
+
+/// @brief Frees the memory used by the transposition table.
+void destroyTranspositionTable(TranspositionTable *table);
+
+/// @brief Invalidates every entry in O(1) by bumping the generation, and resets the probe counters.
+/// Scores depend on the depth from the root, so results can't be shared between two findBestMove calls.
+void newSearchGeneration(TranspositionTable *table);
+
+/// @brief Looks up a position.
+/// @param table the table
+/// @param key position key, see bitboardKey
+/// @param entry out parameter, filled on a hit
+/// @return true if the position was found
+bool probeTranspositionTable(TranspositionTable *table, uint32_t key, TTEntry *entry);
+
+/// @brief Stores a search result, replacing whatever was in the slot.
+void storeTranspositionTable(TranspositionTable *table, uint32_t key, int value, BoundType bound, int bestCell);
+
+/// @brief Random 64-bit number for a piece on a cell, the Zobrist key of a position is the XOR of these over every piece.
+/// Computed with the splitmix64 mixer instead of a table, so it needs no setup and is the same on every run and thread.
+/// @param cell index of the cell, row * MAX_BOARD_SIZE + col
+/// @param piece BOARD_CROSS or BOARD_NOUGHT
+static inline uint64_t zobristKey(int cell, int piece){
+    uint64_t z = ((uint64_t)cell * 2 + (uint64_t)piece) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/// @brief A search result read back from the shared table.
+typedef struct SharedTTEntry{
+    int value; // score found by the search, wins relative to the stored position
+    BoundType bound;
+    int depth; // number of plies that were searched below the position
+    int bestCell; // best move as row * size + col, -1 if none
+}SharedTTEntry;
+
+/// @brief One slot of the shared table. data packs the result into 64 bits and check holds key ^ data,
+/// so a slot torn by two threads writing at once no longer matches its key and reads as a miss instead of a wrong result.
+typedef struct SharedTTSlot{
+    _Atomic uint64_t check;
+    _Atomic uint64_t data;
+}SharedTTSlot;
+
+/// @brief Lock-free transposition table that every search thread reads and writes at the same time, keyed by Zobrist keys.
+typedef struct SharedTranspositionTable{
+    SharedTTSlot *slots;
+    size_t size; // number of slots, a power of two
+    uint8_t generation;
+}SharedTranspositionTable;
+
+/// @brief Allocates a shared transposition table.
+/// @param size requested number of slots, rounded up to a power of two
+/// @return the new table, terminates the program if memory allocation fails
+SharedTranspositionTable *createSharedTranspositionTable(size_t size);
+
+/// @brief Frees the memory used by the shared transposition table.
+void destroySharedTranspositionTable(SharedTranspositionTable *table);
+
+/// @brief Invalidates every entry by bumping the generation. Must not run while a search is using the table.
+void newSharedSearchGeneration(SharedTranspositionTable *table);
+
+/// @brief Looks up a position, safe to call from any number of threads.
+/// @param table the table
+/// @param key Zobrist key of the position
+/// @param entry out parameter, filled on a hit
+/// @return true if the position was found
+bool probeSharedTable(SharedTranspositionTable *table, uint64_t key, SharedTTEntry *entry);
+
+/// @brief Stores a search result, safe to call from any number of threads.
+/// An entry for the same position from the current search is only replaced by one searched at least as deep.
+void storeSharedTable(SharedTranspositionTable *table, uint64_t key, int value, BoundType bound, int depth, int bestCell);
+
+#endif
@@ -4,14 +4,19 @@
 // The game will terminate after.
 void endGameUi();
 
+/// @brief prompts the user to select the board size and win length from BOARD_PRESETS. Contains error handling for invalid inputs.
+/// @return returns the selected board config.
+BoardConfig selectBoardSizeUi();
+
 /// @brief prompts the user to select the opponent they will be playing against. Contains error handling for invalid inputs.
+/// @param config the selected board, the difficulty and the available opponents depend on it.
 /// @return returns a PlayerType corresponding to the opponent the player is playing against.
-PlayerType selectOpponentTypeUi();
+PlayerType selectOpponentTypeUi(BoardConfig config);
 
-/// @brief Prompts the user for the next move (e.g. redo, undo, surrender, etc). Contains error handling for invalid moves.
+/// @brief Prompts the user for the next move as a column letter and row number, e.g. "A3". Contains error handling for invalid moves.
 void selectMoveUi();
 
-/// @brief refreshes the terminal ui with the latest tic tac toe board state. Row = A,B,C Col = 1,2,3
+/// @brief refreshes the terminal ui with the latest tic tac toe board state. Row = A,B,C... Col = 1,2,3...
 void refreshUi();
 
 /// @brief Loads the start game ui to prompt the user to select opponent type and difficulty. Contains error handling for invalid inputs.
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include <util.h>
+#include <bitboard.h>
+#include <game.h>
+
+#ifndef ULTIMATE_H
+#define ULTIMATE_H
+
+// Ultimate tic-tac-toe: 9 classic boards laid out 3x3. A move in cell c of a board sends the opponent to board c,
+// unless that board is already won or full, then they may play in any open board. Winning a board claims that cell
+// of the big board, and three claimed boards in a row win the game. It is a draw once every board is closed.
+
+// Cells of the whole game, 9 boards of 9
+#define ULTIMATE_CELLS 81
+// Rows and columns of the whole game as the gui and tui draw it
+#define ULTIMATE_SIZE 9
+// Value of UltimateBoard.forced when the next move may go to any open board
+#define ULTIMATE_ANY_BOARD -1
+// Value of UltimateBoard.winner when every board closed without three in a row
+#define ULTIMATE_DRAW 3
+
+/// @brief Complete position of an ultimate game in 46 bytes, copied rather than undone by the search.
+/// A move is numbered board * 9 + cell, both counted row by row like the cells of a Bitboard.
+typedef struct UltimateBoard{
+    Bitboard boards[9]; // pieces of each small board
+    Bitboard macro; // small boards won by each side, as cells of the big board
+    uint16_t closed; // small boards that are won or full, nothing can be played there
+    int8_t forced; // small board the next move has to go to, ULTIMATE_ANY_BOARD if any open one
+    int8_t toMove; // BOARD_CROSS or BOARD_NOUGHT
+    int8_t winner; // BOARD_EMPTY while the game goes on, BOARD_CROSS, BOARD_NOUGHT or ULTIMATE_DRAW
+    uint8_t movesMade;
+}UltimateBoard;
+
+/// @brief Every position of one game, for undo and redo without replaying moves.
+typedef struct UltimateGame{
+    UltimateBoard positions[ULTIMATE_CELLS + 1]; // positions[i] is the board after i moves
+    int moves[ULTIMATE_CELLS]; // moves[i] led from positions[i] to positions[i + 1]
+    int current; // moves played, positions[current] is on the board
+    int last; // moves that can be redone up to
+}UltimateGame;
+
+/// @brief Sets up the empty board, X to move anywhere.
+void initUltimateBoard(UltimateBoard *board);
+
+/// @brief Lists the legal moves, in board order.
+/// @param board the position
+/// @param moves out parameter, board * 9 + cell of every legal move
+/// @return number of moves, 0 once the game is over
+int generateUltimateMoves(const UltimateBoard *board, uint8_t moves[ULTIMATE_CELLS]);
+
+/// @brief Checks if a move may be played in the position.
+bool isUltimateMoveLegal(const UltimateBoard *board, int move);
+
+/// @brief Plays a legal move for the side to move and updates the closed boards, the send rule and the winner.
+/// Constant time, only the board the move was played in can change.
+void playUltimateMove(UltimateBoard *board, int move);
+
+/// @brief Piece on a cell of the whole game.
+/// @param board the position
+/// @param row 0 to 8, top to bottom
+/// @param col 0 to 8, left to right
+/// @return BOARD_EMPTY, BOARD_CROSS or BOARD_NOUGHT
+int ultimatePieceAt(const UltimateBoard *board, int row, int col);
+
+/// @brief Converts a row and column of the whole game (0 to 8) into a move number.
+static inline int ultimateMoveAt(int row, int col){
+    return (row / 3 * 3 + col / 3) * 9 + (row % 3) * 3 + col % 3;
+}
+
+/// @brief Row of the whole game (0 to 8) a move is played on.
+static inline int ultimateMoveRow(int move){
+    return move / 27 * 3 + move % 9 / 3;
+}
+
+/// @brief Column of the whole game (0 to 8) a move is played on.
+static inline int ultimateMoveCol(int move){
+    return move / 9 % 3 * 3 + move % 3;
+}
+
+/// @brief Starts a new game on the empty board.
+void newUltimateGame(UltimateGame *game);
+
+/// @brief Position currently on the board.
+static inline UltimateBoard *ultimateGameBoard(UltimateGame *game){
+    return &game->positions[game->current];
+}
+
+/// @brief Plays a move and forgets the moves that could have been redone.
+/// @return false if the move is illegal, nothing changes then
+bool playUltimateGameMove(UltimateGame *game, int move);
+
+/// @brief Takes back the last move, does nothing at the start of the game.
+void undoUltimateGameMove(UltimateGame *game);
+
+/// @brief Plays the last move taken back again, does nothing if there is none.
+void redoUltimateGameMove(UltimateGame *game);
+
+/// @brief Copies the pieces, the turn and the result of the position into state, so the gui and tui draw an
+/// ultimate game and handle turns and game over like the other boards. X is player 1 when player1StartFirst, like doMove.
+void syncUltimateGameState(GameState *state, const UltimateBoard *board);
+
+/// @brief Undo button of the gui and tui: takes back the last move and syncs state. Against the AI it keeps going
+/// back to the player's previous turn, but never past the AI's first move, like undo does on the other boards.
+void undoUltimateTurn(GameState *state, UltimateGame *game);
+
+/// @brief Redo button of the gui and tui: plays the last move taken back again and syncs state, against the AI
+/// up to the player's next turn like redo.
+void redoUltimateTurn(GameState *state, UltimateGame *game);
+
+#endif
@@ -0,0 +1,27 @@
+#include <util.h>
+#include <minimax.h>
+#include <ultimate.h>
+
+#ifndef ULTIMATE_SEARCH_H
+#define ULTIMATE_SEARCH_H
+
+// Score of a won game for the winner, minus the moves it takes. Evaluations of unfinished positions stay far below it.
+#define ULTIMATE_WIN_SCORE 100000
+
+/// @brief Finds a move for the side to move in an ultimate tic-tac-toe game.
+/// Alpha-beta on copies of the 46 byte board with a heuristic evaluation at the horizon: small boards won, two
+/// in a row on the big board and on the open small boards, and a bonus for being free to play anywhere.
+/// A context->maxDepth below CLASSIC_MAX_DEPTH ("Easy") searches exactly that many moves ahead. Anything deeper
+/// deepens one move at a time until budgetMs runs out and plays the move of the last depth that finished.
+/// The search runs on the calling thread and stops early when the context is cancelled.
+/// @param context settings of the search, stats is updated
+/// @param board the position, left unchanged
+/// @param budgetMs time budget for the timed search, see DEFAULT_MOVE_BUDGET_MS
+/// @return row and column of the move on the 9x9 grid, (-1, -1) if the game is over
+Pair findBestUltimateMove(SearchContext *context, const UltimateBoard *board, int budgetMs);
+
+/// @brief Evaluation of a position the search doesn't look past, exposed for the benchmark.
+/// @return score for the side to move, positive is good for it
+int evaluateUltimateBoard(const UltimateBoard *board);
+
+#endif
@@ -30,4 +30,23 @@ int max(int a, int b);
 /// @return 
 int min(int a, int b);
 
+/// @brief Returns a monotonic timestamp in milliseconds, only meaningful as a difference between two calls.
+/// Uses GetTickCount64 on windows and CLOCK_MONOTONIC elsewhere.
+/// @return milliseconds since an unspecified starting point
+long long currentTimeMillis();
+
+/// @brief Same as currentTimeMillis but in microseconds, for timing things that take less than a millisecond.
+/// @return microseconds since an unspecified starting point
+long long currentTimeMicros();
+
+/// @brief Writes stats as a single human readable line, shared by the gui status bar and the tui verbose mode.
+/// @param stats the stats of a move
+/// @param buffer destination, always null terminated
+/// @param size size of buffer in bytes
+void formatSearchStats(const SearchStats *stats, char *buffer, size_t size);
+
+/// @brief Returns the number of logical processors available, used to size the search thread pool.
+/// @return at least 1
+int cpuCount();
+
 #endif
\ No newline at end of file
@@ -1,4 +1,6 @@
+import os
 import random
+import sys
 import numpy as np
 import tensorflow as tf
 from tensorflow.keras.layers import Dense, Flatten, Dropout
@@ -14,6 +16,28 @@ PLAYER_2 = 1
 AI = -1
 UNASSIGNED = -99
 
+# The 8 winning lines as (row, col) cells, in the order of WIN_LINES in board_tables.h
+WIN_LINES = (
+    ((0, 0), (0, 1), (0, 2)),
+    ((0, 0), (1, 0), (2, 0)),
+    ((0, 0), (1, 1), (2, 2)),
+    ((0, 1), (1, 1), (2, 1)),
+    ((0, 2), (1, 2), (2, 2)),
+    ((0, 2), (1, 1), (2, 0)),
+    ((1, 0), (1, 1), (1, 2)),
+    ((2, 0), (2, 1), (2, 2)),
+)
+
+# tools/gen_board_tables.c also writes them to board_tables.py in the build directory, when there is one they have
+# to match so both sides use the same geometry. Set TTT_BUILD_DIR when the build directory isn't ../build.
+sys.path.insert(0, os.environ.get("TTT_BUILD_DIR", os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "build")))
+try:
+    import board_tables
+except ImportError:
+    board_tables = None
+if board_tables is not None and board_tables.WIN_LINES != WIN_LINES:
+    raise ImportError("WIN_LINES differ from the generated board_tables.py, rebuild or update python/ttt.py")
+
 class GameState:
     def __init__(self):
         self.board = [[BOARD_EMPTY for _ in range(3)] for _ in range(3)]
@@ -52,18 +76,9 @@ def check_win(board):
     Returns:
         bool: True if there is a winner, False otherwise.
     """
-    # Check rows
-    for row in board:
-        if row[0] != BOARD_EMPTY and row[0] == row[1] == row[2]:
-            return True
-    # Check columns
-    for col in range(3):
-        if board[0][col] != BOARD_EMPTY and board[0][col] == board[1][col] == board[2][col]:
+    for (r1, c1), (r2, c2), (r3, c3) in WIN_LINES:
+        if board[r1][c1] != BOARD_EMPTY and board[r1][c1] == board[r2][c2] == board[r3][c3]:
             return True
-    # Check diagonals
-    if (board[0][0] != BOARD_EMPTY and board[0][0] == board[1][1] == board[2][2]) or \
-       (board[0][2] != BOARD_EMPTY and board[0][2] == board[1][1] == board[2][0]):
-        return True
     return False
 
 def check_draw(board):
@@ -0,0 +1,61 @@
+#include <include/batch.h>
+#include <include/thread_pool.h>
+
+/// @brief Work shared by the threads of solvePositions.
+typedef struct BatchJob{
+    BatchPosition *positions;
+    BatchResult *results;
+    int count;
+    atomic_int next; // index of the next position nobody has taken yet
+    SearchContext **contexts; // one per thread
+}BatchJob;
+
+static void solveBatchPositions(void *arg, int threadIndex)
+{
+    BatchJob *job = arg;
+    SearchContext *context = job->contexts[threadIndex];
+    while (true)
+    {
+        int i = atomic_fetch_add(&job->next, 1);
+        if (i >= job->count)
+            break;
+        BatchPosition *position = &job->positions[i];
+        BatchResult *result = &job->results[i];
+        result->move = solvePosition(context, position->board, position->config, position->toMove, &result->value);
+        result->nodes = context->stats.nodes;
+    }
+}
+
+void solvePositions(BatchPosition *positions, BatchResult *results, int count, int maxDepth, int threads)
+{
+    if (count <= 0)
+        return;
+    // more threads than positions would only sit idle
+    int threadCount = max(1, min(threads, count));
+
+    SearchContext **contexts = malloc(sizeof(SearchContext *) * threadCount);
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if (unlikely(contexts == NULL))
+    {
+        fprintf(stderr, "Memory allocation failed in solvePositions! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    // the parallelism is across positions, so each position is searched by a single thread
+    for (int t = 0; t < threadCount; t++)
+        contexts[t] = createSearchContext(maxDepth, 1);
+
+    BatchJob job;
+    job.positions = positions;
+    job.results = results;
+    job.count = count;
+    atomic_init(&job.next, 0);
+    job.contexts = contexts;
+
+    ThreadPool *pool = createThreadPool(threadCount);
+    runThreadPool(pool, solveBatchPositions, &job);
+    destroyThreadPool(pool);
+
+    for (int t = 0; t < threadCount; t++)
+        destroySearchContext(contexts[t]);
+    free(contexts);
+}
@@ -0,0 +1,46 @@
+#include <include/bitboard.h>
+
+Bitboard canonicalBitboard(Bitboard board, int *symmetry){
+    Bitboard best = board;
+    uint32_t bestKey = bitboardKey(board);
+    *symmetry = 0;
+    for(int s = 1; s < SYMMETRY_COUNT; s++){
+        Bitboard t = transformBitboard(board, s);
+        uint32_t key = bitboardKey(t);
+        if(key < bestKey){
+            best = t;
+            bestKey = key;
+            *symmetry = s;
+        }
+    }
+    return best;
+}
+
+Bitboard boardToBitboard(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]){
+    Bitboard ret = {0, 0};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if(board[i][j] == BOARD_CROSS){
+                ret.cross |= cellBit(i, j);
+            }else if(board[i][j] == BOARD_NOUGHT){
+                ret.nought |= cellBit(i, j);
+            }
+        }
+    }
+    return ret;
+}
+
+void bitboardToBoard(Bitboard bitboard, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]){
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            uint16_t bit = cellBit(i, j);
+            if(bitboard.cross & bit){
+                board[i][j] = BOARD_CROSS;
+            }else if(bitboard.nought & bit){
+                board[i][j] = BOARD_NOUGHT;
+            }else{
+                board[i][j] = BOARD_EMPTY;
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <include/board_batch.h>
+
+#if defined(__AVX512BW__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Every kernel works on 16 bit lanes, one board per lane: a side has won when (mask & line) == line for a line,
+// and a line is still open while one side has no piece on it.
+
+#if defined(__AVX512BW__)
+#define BATCH_LANES 32
+
+// compares give a bit per board, the status is then picked with masked moves and narrowed to bytes
+static void evaluateLanes(const uint16_t *cross, const uint16_t *nought, uint8_t *status)
+{
+    __m512i x = _mm512_loadu_si512((const void *)cross);
+    __m512i o = _mm512_loadu_si512((const void *)nought);
+    __m512i zero = _mm512_setzero_si512();
+    __mmask32 crossWon = 0;
+    __mmask32 noughtWon = 0;
+    __mmask32 open = 0;
+    for (int i = 0; i < WIN_LINE_COUNT; i++)
+    {
+        __m512i line = _mm512_set1_epi16((short)WIN_LINES[i]);
+        __m512i crossLine = _mm512_and_si512(x, line);
+        __m512i noughtLine = _mm512_and_si512(o, line);
+        crossWon |= _mm512_cmpeq_epi16_mask(crossLine, line);
+        noughtWon |= _mm512_cmpeq_epi16_mask(noughtLine, line);
+        open |= _mm512_cmpeq_epi16_mask(crossLine, zero) | _mm512_cmpeq_epi16_mask(noughtLine, zero);
+    }
+    __m512i result = _mm512_mask_mov_epi16(zero, (__mmask32)~open, _mm512_set1_epi16(BOARD_DRAWN));
+    result = _mm512_mask_mov_epi16(result, noughtWon, _mm512_set1_epi16(BOARD_NOUGHT_WON));
+    result = _mm512_mask_mov_epi16(result, crossWon, _mm512_set1_epi16(BOARD_CROSS_WON));
+    _mm256_storeu_si256((__m256i *)status, _mm512_cvtepi16_epi8(result));
+}
+
+const char *boardBatchKernel()
+{
+    return "AVX-512BW, 32 boards per instruction";
+}
+
+#elif defined(__AVX2__)
+#define BATCH_LANES 16
+
+// compares give 0xFFFF per board, the status is then picked with blends and narrowed to bytes
+static void evaluateLanes(const uint16_t *cross, const uint16_t *nought, uint8_t *status)
+{
+    __m256i x = _mm256_loadu_si256((const __m256i *)cross);
+    __m256i o = _mm256_loadu_si256((const __m256i *)nought);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i crossWon = zero;
+    __m256i noughtWon = zero;
+    __m256i open = zero;
+    for (int i = 0; i < WIN_LINE_COUNT; i++)
+    {
+        __m256i line = _mm256_set1_epi16((short)WIN_LINES[i]);
+        __m256i crossLine = _mm256_and_si256(x, line);
+        __m256i noughtLine = _mm256_and_si256(o, line);
+        crossWon = _mm256_or_si256(crossWon, _mm256_cmpeq_epi16(crossLine, line));
+        noughtWon = _mm256_or_si256(noughtWon, _mm256_cmpeq_epi16(noughtLine, line));
+        open = _mm256_or_si256(open, _mm256_or_si256(_mm256_cmpeq_epi16(crossLine, zero), _mm256_cmpeq_epi16(noughtLine, zero)));
+    }
+    __m256i result = _mm256_andnot_si256(open, _mm256_set1_epi16(BOARD_DRAWN));
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi16(BOARD_NOUGHT_WON), noughtWon);
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi16(BOARD_CROSS_WON), crossWon);
+    // packus works within 128 bit halves, both halves of the result are in the low 128 bits after it
+    __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+    _mm_storeu_si128((__m128i *)status, packed);
+}
+
+const char *boardBatchKernel()
+{
+    return "AVX2, 16 boards per instruction";
+}
+
+#elif defined(__SSE2__)
+#define BATCH_LANES 8
+
+// SSE2 has no blend, the status is put together from the compare masks with and/andnot
+static void evaluateLanes(const uint16_t *cross, const uint16_t *nought, uint8_t *status)
+{
+    __m128i x = _mm_loadu_si128((const __m128i *)cross);
+    __m128i o = _mm_loadu_si128((const __m128i *)nought);
+    __m128i zero = _mm_setzero_si128();
+    __m128i crossWon = zero;
+    __m128i noughtWon = zero;
+    __m128i open = zero;
+    for (int i = 0; i < WIN_LINE_COUNT; i++)
+    {
+        __m128i line = _mm_set1_epi16((short)WIN_LINES[i]);
+        __m128i crossLine = _mm_and_si128(x, line);
+        __m128i noughtLine = _mm_and_si128(o, line);
+        crossWon = _mm_or_si128(crossWon, _mm_cmpeq_epi16(crossLine, line));
+        noughtWon = _mm_or_si128(noughtWon, _mm_cmpeq_epi16(noughtLine, line));
+        open = _mm_or_si128(open, _mm_or_si128(_mm_cmpeq_epi16(crossLine, zero), _mm_cmpeq_epi16(noughtLine, zero)));
+    }
+    __m128i result = _mm_andnot_si128(open, _mm_set1_epi16(BOARD_DRAWN));
+    result = _mm_or_si128(_mm_andnot_si128(noughtWon, result), _mm_and_si128(noughtWon, _mm_set1_epi16(BOARD_NOUGHT_WON)));
+    result = _mm_or_si128(_mm_andnot_si128(crossWon, result), _mm_and_si128(crossWon, _mm_set1_epi16(BOARD_CROSS_WON)));
+    _mm_storel_epi64((__m128i *)status, _mm_packus_epi16(result, result));
+}
+
+const char *boardBatchKernel()
+{
+    return "SSE2, 8 boards per instruction";
+}
+
+#else
+#define BATCH_LANES 0
+
+const char *boardBatchKernel()
+{
+    return "scalar, 1 board at a time";
+}
+#endif
+
+void evaluateBoardBatch(const BoardBatch *batch, uint8_t *status)
+{
+    int i = 0;
+#if BATCH_LANES > 0
+    for (; i + BATCH_LANES <= batch->count; i += BATCH_LANES)
+        evaluateLanes(batch->cross + i, batch->nought + i, status + i);
+#endif
+    // what is left over doesn't fill a register
+    for (; i < batch->count; i++)
+    {
+        Bitboard board = {batch->cross[i], batch->nought[i]};
+        status[i] = (uint8_t)boardStatus(board);
+    }
+}
@@ -11,6 +11,7 @@
 TF_Graph *graph = NULL;
 TF_Session *session = NULL;
 TF_Status *status = NULL;
+SearchStats dlStats;
 
 static void free_buffer(void *data, size_t length)
 {
@@ -129,7 +130,7 @@ void init_tensorflow(const char *model_path)
 }
 
 // Function to perform inference
-Pair findBestDLMove(int board[3][3], PlayerType currentPlayer, bool playerStartFirst)
+Pair findBestDLMove(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], PlayerType currentPlayer, bool playerStartFirst)
 {
     // Convert board state to a tensor (with float values)
     int64_t input_dim[1] = {9};
@@ -175,8 +176,13 @@ Pair findBestDLMove(int board[3][3], PlayerType currentPlayer, bool playerStartF
     TF_Output inputs[] = {input_op};
     TF_Tensor *input_values[] = {input_tensor};
 
-    // Run the session
+    // Run the session, timing only the inference itself
+    long long inference_start = currentTimeMicros();
     TF_SessionRun(session, NULL, inputs, input_values, 1, outputs, output_values, 1, NULL, 0, NULL, status);
+    dlStats = (SearchStats){0};
+    dlStats.nodes = 1;
+    dlStats.maxDepth = 1;
+    dlStats.timeMs = (currentTimeMicros() - inference_start) / 1000.0;
     char *debug_string = TF_Message(status);
 
     if (TF_GetCode(status) != TF_OK)
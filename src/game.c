@@ -1,234 +1,246 @@
 #include <include/util.h>
 #include <include/game.h>
+#include <line_tables.h>
+#include <pthread.h>
+#include <string.h>
 
-GameState gameState;
+const BoardConfig BOARD_PRESETS[BOARD_PRESET_COUNT] = {BOARD_PRESET_LIST};
 
-void createGameState(PlayerType opponent){
-    // Initialize the board to all zeros (empty)
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            gameState.board[i][j] = BOARD_EMPTY;
+int boardPresetIndex(BoardConfig config){
+    for(int i = 0; i < BOARD_PRESET_COUNT; i++){
+        if(BOARD_PRESETS[i].size == config.size && BOARD_PRESETS[i].winLength == config.winLength)
+            return i;
+    }
+    return -1;
+}
+
+const LineTable *presetLineTable(BoardConfig config){
+    int preset = boardPresetIndex(config);
+    return preset < 0 ? NULL : &PRESET_LINE_TABLES[preset];
+}
+
+// line tables of the boards that aren't presets by size and win length, built the first time a game is created on
+// one and kept for the rest of the program, so a GameState only points at its table and can be copied
+static LineTable *customLineTables[MAX_BOARD_SIZE + 1][MAX_BOARD_SIZE + 1];
+static pthread_mutex_t customLineTablesLock = PTHREAD_MUTEX_INITIALIZER;
+
+static const LineTable *customLineTable(BoardConfig config){
+    pthread_mutex_lock(&customLineTablesLock);
+    LineTable *table = customLineTables[config.size][config.winLength];
+    if(table == NULL){
+        table = malloc(sizeof(LineTable));
+        // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+        if(unlikely(table == NULL)){
+            fprintf(stderr, "Memory allocation failed in createGameState! This might be an Operating System Issue! Terminating.\n");
+            exit(1);
+        }
+        buildLineTable(config, table);
+        customLineTables[config.size][config.winLength] = table;
+    }
+    pthread_mutex_unlock(&customLineTablesLock);
+    return table;
+}
+
+bool isClassicBoard(BoardConfig config){
+    return config.size == 3 && config.winLength == 3;
+}
+
+// the 4 line directions through a cell: horizontal, vertical and both diagonals
+static const int LINE_DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+void buildLineTable(BoardConfig config, LineTable *table){
+    int size = config.size;
+    int span = config.winLength - 1;
+    table->config = config;
+    table->lineCount = 0;
+    for(int cell = 0; cell < MAX_BOARD_SIZE * MAX_BOARD_SIZE; cell++)
+        table->cellLineCount[cell] = 0;
+
+    // every cell starts one line per direction, as long as the line fits on the board
+    for(int row = 0; row < size; row++){
+        for(int col = 0; col < size; col++){
+            for(int d = 0; d < 4; d++){
+                int endRow = row + span * LINE_DIRECTIONS[d][0];
+                int endCol = col + span * LINE_DIRECTIONS[d][1];
+                if(endRow >= size || endCol < 0 || endCol >= size)
+                    continue;
+
+                int line = table->lineCount++;
+                table->lineStart[line] = (int16_t)(row * MAX_BOARD_SIZE + col);
+                table->lineStep[line] = (int16_t)(LINE_DIRECTIONS[d][0] * MAX_BOARD_SIZE + LINE_DIRECTIONS[d][1]);
+                for(int i = 0; i < config.winLength; i++){
+                    int cell = table->lineStart[line] + i * table->lineStep[line];
+                    table->cellLines[cell][table->cellLineCount[cell]++] = (int16_t)line;
+                }
+            }
+        }
+    }
+}
+
+void clearLineCounts(const LineTable *table, LineCounts *lines){
+    for(int i = 0; i < table->lineCount; i++){
+        lines->counts[i][0] = 0;
+        lines->counts[i][1] = 0;
+    }
+    for(int cell = 0; cell < MAX_BOARD_SIZE * MAX_BOARD_SIZE; cell++)
+        lines->cellOpenLines[cell] = table->cellLineCount[cell];
+    lines->openLines = table->lineCount;
+    lines->completedLines = 0;
+    lines->patternScore = 0;
+    lines->threats[0] = 0;
+    lines->threats[1] = 0;
+}
+
+// places piece at row, col and updates the line counters
+static void setCell(GameState *state, int row, int col, int piece){
+    state->board[row][col] = piece;
+    addLinePiece(state->lines, &state->lineCounts, row * MAX_BOARD_SIZE + col, piece == BOARD_CROSS ? 0 : 1);
+    state->movesMade++;
+}
+
+// empties row, col and updates the line counters
+static void clearCell(GameState *state, int row, int col){
+    int piece = state->board[row][col];
+    if(piece == BOARD_EMPTY)
+        return;
+    state->board[row][col] = BOARD_EMPTY;
+    removeLinePiece(state->lines, &state->lineCounts, row * MAX_BOARD_SIZE + col, piece == BOARD_CROSS ? 0 : 1);
+    state->movesMade--;
+}
+
+// empties the whole board, including the unused cells past config.size, and resets the line counters
+static void clearBoard(GameState *state){
+    for (int i = 0; i < MAX_BOARD_SIZE; i++) {
+        for (int j = 0; j < MAX_BOARD_SIZE; j++) {
+            state->board[i][j] = BOARD_EMPTY;
         }
     }
+    if(state->lines != NULL)
+        clearLineCounts(state->lines, &state->lineCounts);
+    else
+        memset(&state->lineCounts, 0, sizeof(state->lineCounts));
+    state->movesMade = 0;
+}
+
+// sets every field of state for a new game on lines, state may be fresh memory so nothing in it is trusted from a
+// previous game
+static void initGameState(GameState *state, PlayerType opponent, BoardConfig config, const LineTable *lines){
+    state->lines = lines;
+    state->config = config;
 
-    gameState.player1StartFirst = rand() % 2;
+    // Initialize the board to all zeros (empty)
+    clearBoard(state);
 
-    gameState.opponent = opponent;
+    state->player1StartFirst = rand() % 2;
 
-    gameState.isDraw = false;
+    // player 1 is always the human
+    state->player = PLAYER_1;
+    state->opponent = opponent;
 
-    // since there is no first move, leave the linkedlist and winner as empty
+    state->isDraw = false;
 
-    gameState.currentMove = NULL;
+    // since there is no first move, leave the history and winner as empty
 
-    gameState.winner = UNASSIGNED;
+    clearMoveHistory(&state->history);
+
+    state->winner = UNASSIGNED;
 
     // initialize the first turn
-    if(gameState.player1StartFirst){
-        gameState.turn = PLAYER_1;
+    if(state->player1StartFirst){
+        state->turn = PLAYER_1;
     }else{
-        gameState.turn = opponent;
+        state->turn = opponent;
     }
 
-    gameState.isStarted = true;
+    state->isStarted = true;
 }
 
-void destroyGameState(){
-    if(gameState.currentMove != NULL){
-        destroyList(gameState.currentMove);
-    }
-    gameState.isStarted = false;
+void createGameState(GameState *state, PlayerType opponent, BoardConfig config){
+    // the presets have generated tables, any other board shares one built the first time it is played
+    const LineTable *lines = presetLineTable(config);
+    initGameState(state, opponent, config, lines != NULL ? lines : customLineTable(config));
 }
 
-bool doMove(int row, int col){
-    int insertChar;
-    if(gameState.player1StartFirst){
-        if(gameState.turn == AI || gameState.turn == PLAYER_2){
-            insertChar = BOARD_NOUGHT;
-        }else{
-            insertChar = BOARD_CROSS;
-        }
-    }else{
-        if(gameState.turn == AI || gameState.turn == PLAYER_2){
-            insertChar = BOARD_CROSS;
-        }else{
-            insertChar = BOARD_NOUGHT;
-        }
-    }
+void createMirroredGameState(GameState *state, PlayerType opponent, BoardConfig config){
+    initGameState(state, opponent, config, NULL);
+}
 
-    // if the move is illegal, and attempts to replace an existing move, disallow it.
-    if(gameState.board[row][col] != BOARD_EMPTY)
-        return false;
+void destroyGameState(GameState *state){
+    clearMoveHistory(&state->history);
+    state->isStarted = false;
+}
 
-    gameState.board[row][col] = insertChar;
+// X is always drawn first, so the piece of a player follows from who started
+static int playerPiece(const GameState *state, PlayerType player){
+    bool isPlayer1 = player == PLAYER_1;
+    return isPlayer1 == state->player1StartFirst ? BOARD_CROSS : BOARD_NOUGHT;
+}
 
-    Node* currentMoveNode = createNode(gameState.turn, row, col, NULL, NULL);
+bool doMove(GameState *state, int row, int col){
+    // if the move is illegal, and attempts to replace an existing move or is off the board, disallow it.
+    if(row < 0 || col < 0 || row >= state->config.size || col >= state->config.size)
+        return false;
+    if(state->board[row][col] != BOARD_EMPTY)
+        return false;
 
-    // make use of branch predictor hints here to increase performance during QL training.
-    if(likely(gameState.currentMove != NULL)){ 
-        if(unlikely(gameState.currentMove->Next != NULL)){
-            Node* listNode = gameState.currentMove->Next;  //remove the NEXT node until there are no more moves in the linked list so as to not break REDO and UNDO
-            while (listNode->Next != NULL)
-            {
-                Node* t = listNode->Next;
-                free(t->Prev);
-                listNode = t;
-            }
-            free(listNode); // the loop will traverse until the last node, but it won't free the last node.
+    setCell(state, row, col, playerPiece(state, state->turn));
 
-            // set the current move's next pointer to NULL
-            gameState.currentMove->Next = NULL;
-        }
-        insertNodeHead(&gameState.currentMove, currentMoveNode);
-    }else{
-        gameState.currentMove = currentMoveNode;
-    }
+    // a new move replaces whatever could have been redone, which only takes resetting the count
+    pushMove(&state->history, state->turn, row, col);
     return true;
 }
 
-bool checkDraw(){
-    if(unlikely(!isMovesLeft(gameState.board))){
-        gameState.isDraw = true;
+bool checkDraw(GameState *state){
+    if(unlikely(state->movesMade == state->config.size * state->config.size)){
+        state->isDraw = true;
         return true;
     }
-    // if there's no win, check for draw
-    int drawCount = 0;
-
-    // create a temp list to avoid unnecessary memory allocations
-    int t[3] = {0, 0, 0};
-    int a;
-    int b;
-    int c;
-    int numX;
-    int numO;
-
-    /* So far this is the *second* most efficient method I can think of to early draw detection
-    The MOST efficient would be to represent each O and X as a prime number, then use
-    prime factorization to count the number of O and X using modulo. */
-
-    // check for line (x-x-x) draws
-    for(int i = 0; i < 3; i++){
-        numX = 0;
-        numO = 0;
-        a = gameState.board[i][0];
-        b = gameState.board[i][1];
-        c = gameState.board[i][2];
-        t[0] = a; t[1] = b; t[2] = c;
-        for(int j = 0; j < 3; j++){
-            if(t[j] == BOARD_CROSS){
-                numO++;
-            }else if(t[j] == BOARD_NOUGHT){
-                numX++;
-            }
-        }
-        if(numO > 0 && numX > 0){
-            drawCount++;
-        }
-    }
 
-    // check for cross draws
-    a = gameState.board[0][0];
-    b = gameState.board[1][1];
-    c = gameState.board[2][2];
-    numX = 0;
-    numO = 0;
-    t[0] = a; t[1] = b; t[2] = c;
-    for(int j = 0; j < 3; j++){
-        if(t[j] == BOARD_CROSS){
-            numO++;
-        }else if(t[j] == BOARD_NOUGHT){
-            numX++;
-        }
-    }
-    if(numO > 0 && numX > 0){
-        drawCount++;
-    }
+    // if there's no win, it is an early draw when every line holds both an X and an O
+    return state->lineCounts.openLines == 0;
+}
 
-    // check for cross draws
-    a = gameState.board[2][0];
-    b = gameState.board[1][1];
-    c = gameState.board[0][2];
-    numX = 0;
-    numO = 0;
-    t[0] = a; t[1] = b; t[2] = c;
-    for(int j = 0; j < 3; j++){
-        if(t[j] == BOARD_CROSS){
-            numO++;
-        }else if(t[j] == BOARD_NOUGHT){
-            numX++;
-        }
-    }
-    if(numO > 0 && numX > 0){
-        drawCount++;
-    }            
-
-    for(int i = 0; i < 3; i++){
-        numX = 0;
-        numO = 0;
-        a = gameState.board[0][i];
-        b = gameState.board[1][i];
-        c = gameState.board[2][i];
-        t[0] = a; t[1] = b; t[2] = c;
-        for(int j = 0; j < 3; j++){
-            if(t[j] == BOARD_CROSS){
-                numO++;
-            }else if(t[j] == BOARD_NOUGHT){
-                numX++;
+bool isWinningMove(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int row, int col){
+    int piece = board[row][col];
+    if(piece == BOARD_EMPTY)
+        return false;
+
+    for(int d = 0; d < 4; d++){
+        int count = 1;
+        // walk both ways from the move, stopping at the first cell that isn't ours
+        for(int sign = -1; sign <= 1; sign += 2){
+            int r = row + sign * LINE_DIRECTIONS[d][0];
+            int c = col + sign * LINE_DIRECTIONS[d][1];
+            while(r >= 0 && c >= 0 && r < config.size && c < config.size && board[r][c] == piece){
+                count++;
+                r += sign * LINE_DIRECTIONS[d][0];
+                c += sign * LINE_DIRECTIONS[d][1];
             }
         }
-        if(numO > 0 && numX > 0){
-            drawCount++;
-        }                
-    }
-    if(drawCount == 8){
-        return true;
+        if(count >= config.winLength)
+            return true;
     }
     return false;
 }
 
-bool checkWin(){
-    bool win = false;
-    int cmp; // the comparator to compare against
-
-    // check for line (x-x-x) wins
-    for(int i = 0; i < 3; i++){
-        cmp = gameState.board[i][0];
-        if(cmp == 0) // skip this loop if cmp is 0, which is not worth comparing
-            continue;
-        win = (gameState.board[i][1] == cmp && gameState.board[i][2] == cmp) || win;
-    }
-
-    // check for cross wins
-    cmp = gameState.board[0][0];
-    win = (cmp != 0 && (gameState.board[1][1] == cmp && gameState.board[2][2] == cmp)) || win;
-
-    cmp = gameState.board[2][0];
-    win = (cmp != 0 && (gameState.board[1][1] == cmp && gameState.board[0][2] == cmp)) || win;
-
-    // check for vertical line wins
-    for(int i = 0; i < 3; i++){
-        cmp = gameState.board[0][i];
-        if(cmp == 0) // skip this loop if cmp is 0, which is not worth comparing
-            continue;
-        win = (gameState.board[1][i] == cmp && gameState.board[2][i] == cmp) || win;
-    }
-    return win;
+bool checkWin(const GameState *state){
+    return state->lineCounts.completedLines > 0;
 }
 
-void nextTurn(){
-    bool win = checkWin();
+void nextTurn(GameState *state){
+    bool win = checkWin(state);
     if(win){
         // the winner can only be the one that is currently playing the turn.
-        gameState.winner = gameState.turn;
+        state->winner = state->turn;
     }else{
-        gameState.isDraw = checkDraw();
+        state->isDraw = checkDraw(state);
     }
-    gameState.turn = gameState.turn == gameState.player ? gameState.opponent : gameState.player;
+    state->turn = state->turn == state->player ? state->opponent : state->player;
 }
 
-bool isMovesLeft(int board[3][3]) {
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
+bool isMovesLeft(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config) {
+    for (int i = 0; i < config.size; i++) {
+        for (int j = 0; j < config.size; j++) {
             if (board[i][j] == BOARD_EMPTY) {
                 return true;
             }
@@ -237,100 +249,77 @@ bool isMovesLeft(int board[3][3]) {
     return false;
 }
 
-void undo(){
-    // you can't traverse a linked list without a link or a list, can you?
-    if(gameState.currentMove == NULL)
+void undo(GameState *state){
+    MoveHistory *history = &state->history;
+    if(history->current == 0)
         return;
-    // allow the player to traverse back to an empty board, unless AI starts first.
-    if(gameState.currentMove->Prev == NULL 
-    && gameState.currentMove->player != AI 
-    && gameState.player1StartFirst
-    && gameState.opponent == AI){
-        // empty the board
-        for (int i = 0; i < 3; i++)
-        {
-            for (int j = 0; j < 3; j++)
-            {
-                gameState.board[i][j] = BOARD_EMPTY;
-            }   
-        }
-
-        gameState.turn = gameState.player;
-        return; 
-        // add additional logic for when game is 1v1
-    }else if(gameState.currentMove->Prev == NULL && gameState.opponent == PLAYER_2){
-        // empty the board
-        for (int i = 0; i < 3; i++)
-        {
-            for (int j = 0; j < 3; j++)
-            {
-                gameState.board[i][j] = BOARD_EMPTY;
-            }   
-        }
-
-        if(gameState.player1StartFirst)
-            gameState.turn = PLAYER_1;
-        else
-            gameState.turn = PLAYER_2;
-    }
 
-    if(gameState.currentMove->Prev == NULL)
+    const MoveRecord *first = moveAt(history, 0);
+    if(history->current == 1){
+        // the AI's first move stays, there is nothing before it the player could have done differently
+        if(first->player == AI)
+            return;
+        // back to the empty board, whoever started is to move again
+        clearCell(state, first->row, first->col);
+        history->current = 0;
+        state->turn = first->player;
         return;
+    }
 
-    int row = gameState.currentMove->row;
-    int col = gameState.currentMove->col;
-
-    gameState.board[row][col] = BOARD_EMPTY;
-
-    gameState.currentMove = gameState.currentMove->Prev;
+    const MoveRecord *move = moveAt(history, --history->current);
+    clearCell(state, move->row, move->col);
 
     // flip the turns, always, as it represents the turn of the last move, so naturally next move is other player.
-    gameState.turn = gameState.currentMove->player == gameState.player ? gameState.opponent : gameState.player;
+    const MoveRecord *last = moveAt(history, history->current - 1);
+    state->turn = last->player == state->player ? state->opponent : state->player;
 
     // never never never allow the player to stop at their own turn, it can lead to extra turns.
-    if(gameState.currentMove->player == PLAYER_1 && gameState.opponent == AI)
-        undo();
+    if(last->player == PLAYER_1 && state->opponent == AI)
+        undo(state);
 }
 
-void redo(){
-    // you can't traverse a linked list without a link or a list, can you?
-    if(gameState.currentMove == NULL || gameState.currentMove->Next == NULL)
+void redo(GameState *state){
+    MoveHistory *history = &state->history;
+    if(history->current == history->count)
         return;
 
-    int row, col;
-    if(gameState.board[gameState.currentMove->row][gameState.currentMove->col] != BOARD_EMPTY){
-        // traverse to the next linked list
-        gameState.currentMove = gameState.currentMove->Next;
+    const MoveRecord *move = moveAt(history, history->current++);
+    setCell(state, move->row, move->col, playerPiece(state, move->player));
 
-        // flip the turns, always, as it represents the turn of the last move, so naturally next move is other player.
-        gameState.turn = gameState.currentMove->player == gameState.player ? gameState.opponent : gameState.player;
-        row = gameState.currentMove->row;
-        col = gameState.currentMove->col;
-    }else{
-        // handle special cases when undo was executed all the way until board was empty, so no need to traverse to restore.
-        row = gameState.currentMove->row;
-        col = gameState.currentMove->col;
-    }
+    // flip the turns, always, as it represents the turn of the last move, so naturally next move is other player.
+    state->turn = move->player == state->player ? state->opponent : state->player;
+
+    //never never never allow the player to stop at their own turn, it can lead to extra turns.
+    if(move->player == PLAYER_1 && state->opponent == AI)
+        redo(state);
+}
 
-    // select the proper character to be inserted
-    int insertChar;
+bool jumpToPly(GameState *state, int ply){
+    MoveHistory *history = &state->history;
+    if(ply < 0 || ply > history->count)
+        return false;
 
-    if(gameState.player1StartFirst){
-        if(gameState.currentMove->player == AI || gameState.currentMove->player == PLAYER_2){
-            insertChar = BOARD_NOUGHT;
-        }else{
-            insertChar = BOARD_CROSS;
-        }
-    }else{
-        if(gameState.currentMove->player == AI || gameState.currentMove->player == PLAYER_2){
-            insertChar = BOARD_CROSS;
-        }else{
-            insertChar = BOARD_NOUGHT;
-        }
+    while(history->current > ply){
+        const MoveRecord *move = moveAt(history, --history->current);
+        clearCell(state, move->row, move->col);
+    }
+    while(history->current < ply){
+        const MoveRecord *move = moveAt(history, history->current++);
+        setCell(state, move->row, move->col, playerPiece(state, move->player));
     }
-    gameState.board[row][col] = insertChar;
 
-    //never never never allow the player to stop at their own turn, it can lead to extra turns.
-    if(gameState.currentMove->player == PLAYER_1 && gameState.opponent == AI)
-        redo();
-}
\ No newline at end of file
+    // the next move belongs to whoever didn't make the last one, on the empty board to whoever starts
+    state->winner = UNASSIGNED;
+    state->isDraw = false;
+    if(ply == 0){
+        state->turn = state->player1StartFirst ? PLAYER_1 : state->opponent;
+        return true;
+    }
+    PlayerType last = moveAt(history, ply - 1)->player;
+    if(checkWin(state))
+        state->winner = last;
+    else
+        state->isDraw = checkDraw(state);
+    state->turn = last == state->player ? state->opponent : state->player;
+    return true;
+}
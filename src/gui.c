@@ -6,37 +6,78 @@
 #include <string.h>
 #include <include/definitions.h>
 #include <include/deep_q.h>
+#include <include/mcts.h>
 #include <include/sound.h>
+#include <include/opening_book.h>
+#include <include/solved_database.h>
+#include <include/ponder.h>
+#include <include/ultimate_search.h>
+#include <include/qubic_search.h>
 
 // Define the GUI elements
 GtkWidget *window;
 GtkWidget *grid;
-GtkWidget *buttons[3][3];
+GtkWidget *board_grid;
+GtkWidget *buttons[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
 GtkWidget *mode_combo_box;
 GtkWidget *difficulty_combo_box;
+GtkWidget *board_size_combo_box;
 GtkWidget *undo_button;
 GtkWidget *redo_button;
 GtkWidget *surrender_button;
 GtkWidget *restart_button;
 GtkWidget *start_button;
+GtkWidget *stats_check_button;
+GtkWidget *ponder_check_button;
+GtkWidget *status_bar;
 
+// the game on the board, every rule function is handed this one
+GameState game_state;
 PlayerType opponent = AI;
 bool aiIsDeepLearning = false;
+bool aiIsMonteCarlo = false;
 bool first_start = true;
+int difficulty = 0;
+// board size picked in the combo box, the grid of buttons always matches it
+BoardConfig board_config = {3, 3};
+// the last entry of the board combo box, board_config is then the 9x9 grid of cells
+bool ultimate_mode = false;
+// every position of the ultimate game being played, game_state mirrors the current one
+UltimateGame ultimate_game;
+// the entry after ultimate, the four layers of the cube are drawn 2x2 on an 8x8 grid
+bool qubic_mode = false;
+QubicGame qubic_game;
+// settings and memory of the AI searches, live as long as the gui
+SearchContext *search_context;
+// precomputed openings of the larger boards, NULL when there's no book file
+OpeningBook *opening_book;
+// every position of a small board solved, NULL when there's no database file
+SolvedDatabase *solved_database;
+// searches the AI's answers in the background while the player thinks, borrows search_context
+Ponder *ponder;
+MctsContext *mcts_context;
+
+// Checks if the player may click a cell, in ultimate only the cells of the board the last move sent them to
+static bool is_cell_playable(int row, int col)
+{
+    if (game_state.board[row][col] != 0 || game_state.isStarted != TRUE || game_state.winner != UNASSIGNED)
+        return false;
+    return !ultimate_mode || isUltimateMoveLegal(ultimateGameBoard(&ultimate_game), ultimateMoveAt(row, col));
+}
 
 // Function to refresh the grid
 static void refresh_grid()
 {
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < board_config.size; i++)
     {
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < board_config.size; j++)
         {
-            gtk_widget_set_sensitive(buttons[i][j], gameState.board[i][j] == 0 && gameState.isStarted == TRUE && gameState.winner == UNASSIGNED);
-            if (gameState.board[i][j] == BOARD_CROSS)
+            gtk_widget_set_sensitive(buttons[i][j], is_cell_playable(i, j));
+            if (game_state.board[i][j] == BOARD_CROSS)
             {
                 gtk_button_set_label(GTK_BUTTON(buttons[i][j]), "X");
             }
-            else if (gameState.board[i][j] == BOARD_NOUGHT)
+            else if (game_state.board[i][j] == BOARD_NOUGHT)
             {
                 gtk_button_set_label(GTK_BUTTON(buttons[i][j]), "O");
             }
@@ -48,26 +89,53 @@ static void refresh_grid()
     }
 }
 
+// Shows what the last AI move cost in the status bar, which is only visible while "Show search stats" is ticked
+static void update_status_bar(const char *ai_name, const SearchStats *stats)
+{
+    char stats_line[160];
+    char status_text[200];
+    formatSearchStats(stats, stats_line, sizeof(stats_line));
+    snprintf(status_text, sizeof(status_text), "%s: %s", ai_name, stats_line);
+
+    guint context_id = gtk_statusbar_get_context_id(GTK_STATUSBAR(status_bar), "search stats");
+    gtk_statusbar_remove_all(GTK_STATUSBAR(status_bar), context_id);
+    gtk_statusbar_push(GTK_STATUSBAR(status_bar), context_id, status_text);
+}
+
+// Starts thinking about the AI's answers to the player's next move, when it's the player's turn against minimax on
+// "Impossible" on a board that is searched against the clock. Anything else answers fast enough without it.
+static void start_pondering()
+{
+    bool searches_on_clock = game_state.opponent == AI && !aiIsDeepLearning && !aiIsMonteCarlo && !ultimate_mode && !qubic_mode
+                             && search_context->maxDepth >= CLASSIC_MAX_DEPTH && !isClassicBoard(game_state.config);
+    bool players_turn = game_state.isStarted && game_state.winner == UNASSIGNED && !game_state.isDraw
+                        && game_state.turn != game_state.opponent;
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(ponder_check_button)) && searches_on_clock && players_turn)
+        startPondering(ponder, game_state.board, game_state.config, game_state.opponent, game_state.player1StartFirst);
+}
+
 // Refreshes the buttons to keep it up-to-date with current game
 static void refresh_buttons()
 {
-    if (gameState.winner == UNASSIGNED && gameState.isStarted && !gameState.isDraw)
+    if (game_state.winner == UNASSIGNED && game_state.isStarted && !game_state.isDraw)
     {
         gtk_widget_set_sensitive(start_button, FALSE);
         gtk_widget_set_sensitive(restart_button, FALSE);
         gtk_widget_set_sensitive(difficulty_combo_box, FALSE);
         gtk_widget_set_sensitive(mode_combo_box, FALSE);
+        gtk_widget_set_sensitive(board_size_combo_box, FALSE);
 
         // enable game buttons
         gtk_widget_set_sensitive(undo_button, TRUE);
         gtk_widget_set_sensitive(redo_button, TRUE);
         gtk_widget_set_sensitive(surrender_button, TRUE);
     }
-    else if (gameState.winner != UNASSIGNED || gameState.isDraw)
+    else if (game_state.winner != UNASSIGNED || game_state.isDraw)
     {
         gtk_widget_set_sensitive(restart_button, TRUE);
         gtk_widget_set_sensitive(difficulty_combo_box, TRUE);
         gtk_widget_set_sensitive(mode_combo_box, TRUE);
+        gtk_widget_set_sensitive(board_size_combo_box, TRUE);
 
         // disable game only buttons
         gtk_widget_set_sensitive(undo_button, FALSE);
@@ -78,17 +146,39 @@ static void refresh_buttons()
 
 void startGame()
 {
-    // Initialize the game state
-    createGameState(opponent);
-    if (!gameState.player1StartFirst)
+    // Set the maxDepth for the minimax algorithm based on the selected difficulty and board
+    search_context->maxDepth = difficulty == 0 ? 1 : CLASSIC_MAX_DEPTH;
+    // monte carlo gets a handful of playouts on easy, and the whole time budget on impossible
+    mcts_context->playouts = difficulty == 0 ? MCTS_EASY_PLAYOUTS : 0;
+
+    // Initialize the game state, ultimate and qubic keep their own rules and only copy their board into it
+    if (ultimate_mode || qubic_mode)
+        createMirroredGameState(&game_state, opponent, board_config);
+    else
+        createGameState(&game_state, opponent, board_config);
+    if (ultimate_mode)
+    {
+        newUltimateGame(&ultimate_game);
+        syncUltimateGameState(&game_state, ultimateGameBoard(&ultimate_game));
+    }
+    else if (qubic_mode)
+    {
+        newQubicGame(&qubic_game);
+        syncQubicGameState(&game_state, qubicGameBoard(&qubic_game));
+    }
+    if (!game_state.player1StartFirst)
     {
 
         // do ai move first
-        if (gameState.opponent == AI)
+        if (game_state.opponent == AI)
             do_ai_move();
 
         refresh_grid();
     }
+    else
+    {
+        start_pondering();
+    }
     // disable the start and restart buttons
     refresh_buttons();
 }
@@ -96,32 +186,33 @@ void startGame()
 // Function to handle win/draw logic win_draw true = win, false = draw
 static void handle_win_draw()
 {
+    stopPondering(ponder);
     refresh_grid();
     // Disable all buttons
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < board_config.size; i++)
     {
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < board_config.size; j++)
         {
             gtk_widget_set_sensitive(buttons[i][j], FALSE);
         }
     }
 
     // Show the result
-    if (!gameState.isDraw)
+    if (!game_state.isDraw)
     {
-        if (gameState.opponent == PLAYER_2)
+        if (game_state.opponent == PLAYER_2)
         {
             GtkWidget *dialog = gtk_message_dialog_new(
                 GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT, GTK_MESSAGE_INFO,
-                GTK_BUTTONS_CLOSE, "Game Over! Player %d won!", gameState.winner + 1);
+                GTK_BUTTONS_CLOSE, "Game Over! Player %d won!", game_state.winner + 1);
             gtk_dialog_run(GTK_DIALOG(dialog));
             gtk_widget_destroy(dialog);
 
             play_sound(WIN_SND, false);
         }
-        else if (gameState.opponent == AI)
+        else if (game_state.opponent == AI)
         {
-            if(gameState.winner != gameState.opponent){
+            if(game_state.winner != game_state.opponent){
                 play_sound(WIN_SND, false);
             }else{
                 play_sound(LOSE_SND, false);
@@ -129,7 +220,7 @@ static void handle_win_draw()
             GtkWidget *dialog = gtk_message_dialog_new(
                 GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT, GTK_MESSAGE_INFO,
                 GTK_BUTTONS_CLOSE,
-                gameState.winner == PLAYER_1 ? "Game Over! You Win!"
+                game_state.winner == PLAYER_1 ? "Game Over! You Win!"
                                              : "Game Over! You lose!");
             gtk_dialog_run(GTK_DIALOG(dialog));
             gtk_widget_destroy(dialog);
@@ -148,30 +239,59 @@ static void handle_win_draw()
     refresh_buttons();
 }
 
+// The AI had no legal move to play in a game that isn't over, it gives the game up instead of passing the turn back
+static void forfeit_ai_turn()
+{
+    GtkWidget *dialog = gtk_message_dialog_new(
+        GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT, GTK_MESSAGE_WARNING,
+        GTK_BUTTONS_CLOSE, "The AI couldn't find a move and forfeits the game.");
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+    game_state.winner = game_state.player;
+    handle_win_draw();
+}
+
 // Function to handle button clicks
 static void button_clicked(GtkWidget *widget, gpointer data)
 {
     play_sound(BTN_CLICK_SND, false);
     // Get the row and column of the clicked button
-    int row = GPOINTER_TO_INT(data) / 3;
-    int col = GPOINTER_TO_INT(data) % 3;
+    int row = GPOINTER_TO_INT(data) / MAX_BOARD_SIZE;
+    int col = GPOINTER_TO_INT(data) % MAX_BOARD_SIZE;
 
-    // Do the move
-    bool move_success = doMove(row, col);
+    // Do the move, an ultimate move updates game_state from the ultimate board instead
+    bool move_success;
+    if (ultimate_mode)
+    {
+        move_success = playUltimateGameMove(&ultimate_game, ultimateMoveAt(row, col));
+        if (move_success)
+            syncUltimateGameState(&game_state, ultimateGameBoard(&ultimate_game));
+    }
+    else if (qubic_mode)
+    {
+        move_success = playQubicGameMove(&qubic_game, qubicMoveAt(row, col));
+        if (move_success)
+            syncQubicGameState(&game_state, qubicGameBoard(&qubic_game));
+    }
+    else
+    {
+        move_success = doMove(&game_state, row, col);
+        if (move_success)
+            nextTurn(&game_state);
+    }
     if (move_success)
     {
-        nextTurn();
         gtk_widget_set_sensitive(widget, FALSE);
         refresh_grid();
 
         // Check for win or draw
-        if (gameState.winner != UNASSIGNED || gameState.isDraw)
+        if (game_state.winner != UNASSIGNED || game_state.isDraw)
         {
             handle_win_draw();
             return;
         }
 
-        if (gameState.opponent == AI)
+        if (game_state.opponent == AI)
             do_ai_move();
     }
 }
@@ -179,29 +299,71 @@ static void button_clicked(GtkWidget *widget, gpointer data)
 void do_ai_move()
 {
     // AI move
-    if (gameState.opponent == AI && gameState.winner == UNASSIGNED && !gameState.isDraw)
+    if (game_state.opponent == AI && game_state.winner == UNASSIGNED && !game_state.isDraw)
     {
-        int t_board[3][3];
+        int t_board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
 
         // find the best move with a copy of the array, in order to avoid modifying the current array (pass by ref)
-        memcpy(t_board, gameState.board, sizeof(gameState.board));
+        memcpy(t_board, game_state.board, sizeof(game_state.board));
         Pair pair;
-        if (aiIsDeepLearning)
+        bool played = false;
+        if (ultimate_mode)
+        {
+            // every AI plays ultimate and qubic with their own engines, none of the others know the rules
+            pair = findBestUltimateMove(search_context, ultimateGameBoard(&ultimate_game), DEFAULT_MOVE_BUDGET_MS);
+            update_status_bar("Ultimate", &search_context->stats);
+            played = pair.a >= 0 && playUltimateGameMove(&ultimate_game, ultimateMoveAt(pair.a, pair.b));
+            if (played)
+                syncUltimateGameState(&game_state, ultimateGameBoard(&ultimate_game));
+        }
+        else if (qubic_mode)
+        {
+            pair = findBestQubicMove(search_context, qubicGameBoard(&qubic_game), DEFAULT_MOVE_BUDGET_MS);
+            update_status_bar("Qubic", &search_context->stats);
+            played = pair.a >= 0 && playQubicGameMove(&qubic_game, qubicMoveAt(pair.a, pair.b));
+            if (played)
+                syncQubicGameState(&game_state, qubicGameBoard(&qubic_game));
+        }
+        else if (aiIsDeepLearning)
+        {
+            pair = findBestDLMove(t_board, game_state.turn, game_state.player1StartFirst);
+            update_status_bar("Q-learning", &dlStats);
+        }
+        else if (aiIsMonteCarlo)
+        {
+            pair = findBestMCTSMove(mcts_context, t_board, game_state.config, game_state.turn, game_state.player1StartFirst);
+            update_status_bar("Monte Carlo", &mcts_context->stats);
+        }
+        else if (ponderHit(ponder, t_board, &pair))
         {
-            pair = findBestDLMove(t_board, gameState.turn, gameState.player1StartFirst);
+            // the answer to this move was already searched during the player's turn
+            update_status_bar("Minimax (pondered)", &search_context->stats);
         }
         else
         {
-            pair = findBestMove(t_board, gameState.turn, gameState.player1StartFirst);
+            pair = findBestMove(search_context, t_board, game_state.config, game_state.turn, game_state.player1StartFirst);
+            update_status_bar("Minimax", &search_context->stats);
+        }
+        if (!ultimate_mode && !qubic_mode)
+        {
+            played = doMove(&game_state, pair.a, pair.b);
+            if (played)
+                nextTurn(&game_state);
+        }
+        if (!played)
+        {
+            forfeit_ai_turn();
+            return;
         }
-        doMove(pair.a, pair.b);
-        nextTurn();
         gtk_widget_set_sensitive(buttons[pair.a][pair.b], FALSE);
     }
 
     // Check for win or draw after AI move
-    if (checkWin() || checkDraw())
+    bool game_over = ultimate_mode || qubic_mode ? game_state.winner != UNASSIGNED || game_state.isDraw : checkWin(&game_state) || checkDraw(&game_state);
+    if (game_over)
         handle_win_draw();
+    else
+        start_pondering();
 
     refresh_grid();
 }
@@ -219,6 +381,7 @@ static void mode_combo_box_changed(GtkWidget *widget, gpointer data)
         case 0:
             opponent = AI;
             aiIsDeepLearning = false;
+            aiIsMonteCarlo = false;
             gtk_widget_set_sensitive(difficulty_combo_box, true);
             break;
         case 1:
@@ -227,7 +390,17 @@ static void mode_combo_box_changed(GtkWidget *widget, gpointer data)
         case 2:
             opponent = AI;
             aiIsDeepLearning = true;
+            aiIsMonteCarlo = false;
             gtk_widget_set_sensitive(difficulty_combo_box, false);
+            // the q-learning model was only trained on 3x3
+            if (!isClassicBoard(board_config))
+                gtk_combo_box_set_active(GTK_COMBO_BOX(board_size_combo_box), 0);
+            break;
+        case 3:
+            opponent = AI;
+            aiIsDeepLearning = false;
+            aiIsMonteCarlo = true;
+            gtk_widget_set_sensitive(difficulty_combo_box, true);
             break;
     }
 }
@@ -235,22 +408,38 @@ static void mode_combo_box_changed(GtkWidget *widget, gpointer data)
 // Function to handle difficulty combo box changes
 static void difficulty_combo_box_changed(GtkWidget *widget, gpointer data)
 {
-    // Get the selected difficulty
-    int difficulty = gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+    // Get the selected difficulty, the search depth is set from it when the game starts
+    difficulty = gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+}
 
-    // Set the maxDepth for the minimax algorithm based on the selected difficulty
+// Function to handle the search stats check button, shows or hides the status bar
+static void stats_check_button_toggled(GtkWidget *widget, gpointer data)
+{
+    gtk_widget_set_visible(status_bar, gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
+}
 
-    if (difficulty == 0)
-        MAX_DEPTH = 1;
+// Function to handle the pondering check button, starts or stops thinking on the player's time
+static void ponder_check_button_toggled(GtkWidget *widget, gpointer data)
+{
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)))
+        start_pondering();
     else
-        MAX_DEPTH = 9;
+        stopPondering(ponder);
 }
 
 // Function to handle undo button clicks
 void undo_button_clicked(GtkWidget *widget, gpointer data)
 {
     play_sound(BTN_CLICK_SND, false);
-    undo();
+    // the pondered position is gone, think about the one the player is back to instead
+    stopPondering(ponder);
+    if (ultimate_mode)
+        undoUltimateTurn(&game_state, &ultimate_game);
+    else if (qubic_mode)
+        undoQubicTurn(&game_state, &qubic_game);
+    else
+        undo(&game_state);
+    start_pondering();
     refresh_grid();
 }
 
@@ -258,7 +447,14 @@ void undo_button_clicked(GtkWidget *widget, gpointer data)
 void redo_button_clicked(GtkWidget *widget, gpointer data)
 {
     play_sound(BTN_CLICK_SND, false);
-    redo();
+    stopPondering(ponder);
+    if (ultimate_mode)
+        redoUltimateTurn(&game_state, &ultimate_game);
+    else if (qubic_mode)
+        redoQubicTurn(&game_state, &qubic_game);
+    else
+        redo(&game_state);
+    start_pondering();
     refresh_grid();
 }
 
@@ -267,22 +463,23 @@ static void surrender_button_clicked(GtkWidget *widget, gpointer data)
 {
     play_sound(BTN_CLICK_SND, false);
     play_sound(SURRENDER_SND, false);
+    stopPondering(ponder);
     // Determine the winner
-    gameState.winner =
-        (gameState.turn == gameState.player) ? gameState.opponent : gameState.player;
+    game_state.winner =
+        (game_state.turn == game_state.player) ? game_state.opponent : game_state.player;
 
     // Show the result
     GtkWidget *dialog;
-    if(gameState.opponent != AI){
+    if(game_state.opponent != AI){
         dialog = gtk_message_dialog_new(
             GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT, GTK_MESSAGE_INFO,
             GTK_BUTTONS_CLOSE, "Game Over! %s won!",
-            gameState.winner == PLAYER_1 ? "Player 1" : "Player 2");
+            game_state.winner == PLAYER_1 ? "Player 1" : "Player 2");
     }else{
         dialog = gtk_message_dialog_new(
             GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT, GTK_MESSAGE_INFO,
             GTK_BUTTONS_CLOSE, "Game Over! %s won!",
-            gameState.winner == PLAYER_1 ? "You" : "AI");
+            game_state.winner == PLAYER_1 ? "You" : "AI");
     }
     gtk_dialog_run(GTK_DIALOG(dialog));
     gtk_widget_destroy(dialog);
@@ -300,9 +497,9 @@ static void start_button_clicked(GtkWidget *widget, gpointer data)
         first_start = false;
     }
     // Reset the button labels and sensitivities
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < board_config.size; i++)
     {
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < board_config.size; j++)
         {
             gtk_button_set_label(GTK_BUTTON(buttons[i][j]), "");
             gtk_widget_set_sensitive(buttons[i][j], TRUE);
@@ -319,8 +516,10 @@ static void start_button_clicked(GtkWidget *widget, gpointer data)
 static void restart_button_clicked(GtkWidget *widget, gpointer data)
 {
     play_sound(BTN_CLICK_SND, false);
+    // whatever was pondered belongs to the old game
+    stopPondering(ponder);
     // Reset the game state
-    destroyGameState();
+    destroyGameState(&game_state);
     start_button_clicked(widget, data);
 }
 
@@ -344,42 +543,91 @@ static void update_font_size(GtkWidget *widget, GdkRectangle *allocation, gpoint
     pango_font_description_free(font_desc);
 }
 
-// Function to create the main window
-static void activate(GtkApplication *app, gpointer user_data)
+// Replaces the buttons in the board grid with board_config.size x board_config.size new ones
+static void rebuild_board_grid()
 {
-    // Create the main window
-    window = gtk_application_window_new(app);
-    gtk_window_set_title(GTK_WINDOW(window), "Tic Tac Toe");
-    gtk_window_set_default_size(GTK_WINDOW(window), 300, 400);
-
-    // Create a vertical box to hold the grid
-    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5); // 5 is spacing between elements
-    gtk_container_add(GTK_CONTAINER(window), vbox);
+    // destroy the buttons of the previous board size
+    GList *children = gtk_container_get_children(GTK_CONTAINER(board_grid));
+    for (GList *child = children; child != NULL; child = child->next)
+        gtk_widget_destroy(GTK_WIDGET(child->data));
+    g_list_free(children);
 
-    // Create the grid
-    grid = gtk_grid_new();
-    gtk_box_pack_start(GTK_BOX(vbox), grid, TRUE, TRUE, 0);
+    // keep the board roughly the same size on screen whatever the number of cells
+    int button_size = 600 / board_config.size;
 
     // Create grid buttons
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < board_config.size; i++)
     {
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < board_config.size; j++)
         {
             buttons[i][j] = gtk_button_new();
             // let the button expand with window
             gtk_widget_set_hexpand(buttons[i][j], TRUE);
             gtk_widget_set_vexpand(buttons[i][j], TRUE);
 
-            gtk_widget_set_size_request(buttons[i][j], 200, 200);
-            gtk_grid_attach(GTK_GRID(grid), buttons[i][j], i, j, 1, 1);
+            gtk_widget_set_size_request(buttons[i][j], button_size, button_size);
+            // a gap between the small boards of ultimate and the layers of the cube
+            int block = ultimate_mode ? 3 : qubic_mode ? 4 : 0;
+            if (block != 0 && i % block == block - 1 && i != board_config.size - 1)
+                gtk_widget_set_margin_end(buttons[i][j], 8);
+            if (block != 0 && j % block == block - 1 && j != board_config.size - 1)
+                gtk_widget_set_margin_bottom(buttons[i][j], 8);
+            gtk_grid_attach(GTK_GRID(board_grid), buttons[i][j], i, j, 1, 1);
             // connect with the on click function
             g_signal_connect(buttons[i][j], "clicked", G_CALLBACK(button_clicked),
-                             GINT_TO_POINTER(i * 3 + j));
+                             GINT_TO_POINTER(i * MAX_BOARD_SIZE + j));
 
             // Connect to "size-allocate" signal to update font size on resize
             g_signal_connect(buttons[i][j], "size-allocate", G_CALLBACK(update_font_size), buttons[i][j]);
         }
     }
+    gtk_widget_show_all(board_grid);
+}
+
+// Function to handle board size combo box changes
+static void board_size_combo_box_changed(GtkWidget *widget, gpointer data)
+{
+    int preset = gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+    if (preset < 0)
+        return;
+    // ultimate and qubic come after the presets, their cells are drawn as one 9x9 and one 8x8 grid
+    ultimate_mode = preset == BOARD_PRESET_COUNT;
+    qubic_mode = preset == BOARD_PRESET_COUNT + 1;
+    if (ultimate_mode)
+        board_config = (BoardConfig){ULTIMATE_SIZE, 3};
+    else if (qubic_mode)
+        board_config = (BoardConfig){QUBIC_GRID_SIZE, 4};
+    else
+        board_config = BOARD_PRESETS[preset];
+
+    // the q-learning model was only trained on 3x3, fall back to minimax on anything else
+    if (aiIsDeepLearning && !isClassicBoard(board_config))
+        gtk_combo_box_set_active(GTK_COMBO_BOX(mode_combo_box), 0);
+
+    rebuild_board_grid();
+    refresh_grid();
+}
+
+// Function to create the main window
+static void activate(GtkApplication *app, gpointer user_data)
+{
+    // Create the main window
+    window = gtk_application_window_new(app);
+    gtk_window_set_title(GTK_WINDOW(window), "Tic Tac Toe");
+    gtk_window_set_default_size(GTK_WINDOW(window), 300, 400);
+
+    // Create a vertical box to hold the grid
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5); // 5 is spacing between elements
+    gtk_container_add(GTK_CONTAINER(window), vbox);
+
+    // Create the board grid, its buttons are created by rebuild_board_grid whenever the board size changes
+    board_grid = gtk_grid_new();
+    gtk_box_pack_start(GTK_BOX(vbox), board_grid, TRUE, TRUE, 0);
+    rebuild_board_grid();
+
+    // Create the grid for the controls
+    grid = gtk_grid_new();
+    gtk_box_pack_start(GTK_BOX(vbox), grid, FALSE, FALSE, 0);
 
     // Create the mode combo box
     GtkWidget *mode_label = gtk_label_new("Opponent:");
@@ -390,6 +638,8 @@ static void activate(GtkApplication *app, gpointer user_data)
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(mode_combo_box), "1v1 Human");
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(mode_combo_box),
                                    "Qlearning AI");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(mode_combo_box),
+                                   "AI Monte Carlo");
     gtk_grid_attach(GTK_GRID(grid), mode_combo_box, 1, 3, 2, 1);
     g_signal_connect(mode_combo_box, "changed",
                      G_CALLBACK(mode_combo_box_changed), NULL);
@@ -407,42 +657,79 @@ static void activate(GtkApplication *app, gpointer user_data)
     g_signal_connect(difficulty_combo_box, "changed",
                      G_CALLBACK(difficulty_combo_box_changed), NULL);
 
+    // Create the board size combo box
+    GtkWidget *board_size_label = gtk_label_new("Board:");
+    gtk_grid_attach(GTK_GRID(grid), board_size_label, 0, 5, 1, 1);
+
+    board_size_combo_box = gtk_combo_box_text_new();
+    for (int i = 0; i < BOARD_PRESET_COUNT; i++)
+    {
+        char preset_name[32];
+        snprintf(preset_name, sizeof(preset_name), "%dx%d, %d in a row",
+                 BOARD_PRESETS[i].size, BOARD_PRESETS[i].size, BOARD_PRESETS[i].winLength);
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(board_size_combo_box), preset_name);
+    }
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(board_size_combo_box), "Ultimate, 3x3 of 3x3");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(board_size_combo_box), "Qubic, 4x4x4");
+    gtk_grid_attach(GTK_GRID(grid), board_size_combo_box, 1, 5, 2, 1);
+    g_signal_connect(board_size_combo_box, "changed",
+                     G_CALLBACK(board_size_combo_box_changed), NULL);
+
     // Create the undo button
     undo_button = gtk_button_new_with_label("Undo");
-    gtk_grid_attach(GTK_GRID(grid), undo_button, 0, 5, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), undo_button, 0, 6, 1, 1);
     g_signal_connect(undo_button, "clicked", G_CALLBACK(undo_button_clicked),
                      NULL);
 
     // Create the redo button
     redo_button = gtk_button_new_with_label("Redo");
-    gtk_grid_attach(GTK_GRID(grid), redo_button, 1, 5, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), redo_button, 1, 6, 1, 1);
     g_signal_connect(redo_button, "clicked", G_CALLBACK(redo_button_clicked),
                      NULL);
 
     // Create the surrender button
     surrender_button = gtk_button_new_with_label("Surrender");
-    gtk_grid_attach(GTK_GRID(grid), surrender_button, 2, 5, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), surrender_button, 2, 6, 1, 1);
     g_signal_connect(surrender_button, "clicked",
                      G_CALLBACK(surrender_button_clicked), NULL);
 
     // Create the restart button
     restart_button = gtk_button_new_with_label("Restart");
-    gtk_grid_attach(GTK_GRID(grid), restart_button, 0, 6, 3, 1);
+    gtk_grid_attach(GTK_GRID(grid), restart_button, 0, 7, 3, 1);
     g_signal_connect(restart_button, "clicked",
                      G_CALLBACK(restart_button_clicked), NULL);
 
+    // Create the search stats check button
+    stats_check_button = gtk_check_button_new_with_label("Show search stats");
+    gtk_grid_attach(GTK_GRID(grid), stats_check_button, 0, 8, 3, 1);
+    g_signal_connect(stats_check_button, "toggled",
+                     G_CALLBACK(stats_check_button_toggled), NULL);
+
+    // Create the pondering check button, on by default
+    ponder_check_button = gtk_check_button_new_with_label("Think on your turn");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(ponder_check_button), TRUE);
+    gtk_grid_attach(GTK_GRID(grid), ponder_check_button, 0, 9, 3, 1);
+    g_signal_connect(ponder_check_button, "toggled",
+                     G_CALLBACK(ponder_check_button_toggled), NULL);
+
     // Create the start button
     start_button = gtk_button_new_with_label("Start Game");
     gtk_grid_attach(GTK_GRID(grid), start_button, 0, 10, 3, 4);
     g_signal_connect(start_button, "clicked",
                      G_CALLBACK(restart_button_clicked), NULL);
 
+    // Create the status bar for the search stats, hidden until the check button is ticked
+    status_bar = gtk_statusbar_new();
+    gtk_box_pack_end(GTK_BOX(vbox), status_bar, FALSE, FALSE, 0);
+    gtk_widget_set_no_show_all(status_bar, TRUE);
+
     // Show all widgets
     gtk_widget_show_all(window);
 
     // set the first options as the defaults
     gtk_combo_box_set_active(GTK_COMBO_BOX(difficulty_combo_box), 0);
     gtk_combo_box_set_active(GTK_COMBO_BOX(mode_combo_box), 0);
+    gtk_combo_box_set_active(GTK_COMBO_BOX(board_size_combo_box), 0);
 
     refresh_grid();
     refresh_buttons();
@@ -450,9 +737,26 @@ static void activate(GtkApplication *app, gpointer user_data)
 
 void launch_gui(int argc, char **argv)
 {
+    // one search thread per core for the larger boards
+    search_context = createSearchContext(1, cpuCount());
+    // mapped, not read, so a large book doesn't slow down startup
+    opening_book = openOpeningBook(OPENING_BOOK_PATH);
+    search_context->book = opening_book;
+    solved_database = openPresetDatabase();
+    search_context->database = solved_database;
+    ponder = createPonder(search_context);
+    mcts_context = createMctsContext(MCTS_EASY_PLAYOUTS, DEFAULT_MOVE_BUDGET_MS);
+
     // Create the GTK application
     GtkApplication *app = gtk_application_new("com.kkxln.tictactoe", G_APPLICATION_DEFAULT_FLAGS);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
     int status = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
+
+    // stops the ponder thread before the context it searches with goes away
+    destroyPonder(ponder);
+    destroySearchContext(search_context);
+    closeOpeningBook(opening_book);
+    closeSolvedDatabase(solved_database);
+    destroyMctsContext(mcts_context);
 }
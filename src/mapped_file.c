@@ -0,0 +1,72 @@
+#include <include/mapped_file.h>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool mapFile(const char *path, MappedFile *file)
+{
+    void *mapping = NULL;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    HANDLE mappingHandle = NULL;
+    if (GetFileSizeEx(handle, &fileSize) && fileSize.QuadPart > 0)
+    {
+        size = (size_t)fileSize.QuadPart;
+        mappingHandle = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mappingHandle != NULL)
+            mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (mapping == NULL)
+    {
+        if (mappingHandle != NULL)
+            CloseHandle(mappingHandle);
+        CloseHandle(handle);
+        return false;
+    }
+    file->fileHandle = handle;
+    file->mappingHandle = mappingHandle;
+#else
+    int handle = open(path, O_RDONLY);
+    if (handle < 0)
+        return false;
+    struct stat info;
+    if (fstat(handle, &info) == 0 && info.st_size > 0)
+    {
+        size = (size_t)info.st_size;
+        mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, handle, 0);
+        if (mapping == MAP_FAILED)
+            mapping = NULL;
+    }
+    // the mapping keeps the file alive on its own
+    close(handle);
+    if (mapping == NULL)
+        return false;
+    madvise(mapping, size, MADV_RANDOM);
+#endif
+    file->data = mapping;
+    file->size = size;
+    return true;
+}
+
+void unmapFile(MappedFile *file)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(file->data);
+    CloseHandle(file->mappingHandle);
+    CloseHandle(file->fileHandle);
+#else
+    munmap((void *)file->data, file->size);
+#endif
+    file->data = NULL;
+    file->size = 0;
+}
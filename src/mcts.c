@@ -0,0 +1,272 @@
+#include <include/mcts.h>
+#include <string.h>
+
+MctsContext *createMctsContext(int playouts, int budgetMs)
+{
+    MctsContext *context = malloc(sizeof(MctsContext));
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if (unlikely(context == NULL))
+    {
+        fprintf(stderr, "Memory allocation failed in createMctsContext! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    context->playouts = playouts;
+    context->budgetMs = budgetMs;
+    context->stats = (SearchStats){0};
+    atomic_init(&context->cancelled, false);
+    context->arena = NULL;
+    context->arenaUsed = 0;
+    context->rngState = 0;
+    return context;
+}
+
+void destroyMctsContext(MctsContext *context)
+{
+    if (context == NULL)
+        return;
+    free(context->arena);
+    free(context);
+}
+
+// xorshift64, far cheaper than rand() and good enough to pick random moves
+static inline uint32_t nextRandom(MctsContext *context)
+{
+    context->rngState ^= context->rngState << 13;
+    context->rngState ^= context->rngState >> 7;
+    context->rngState ^= context->rngState << 17;
+    return (uint32_t)(context->rngState >> 32);
+}
+
+static inline int otherPiece(int piece)
+{
+    return piece == BOARD_CROSS ? BOARD_NOUGHT : BOARD_CROSS;
+}
+
+// takes a node from the arena, returns -1 when the arena is full
+static int allocateNode(MctsContext *context, int parent, int cell, int piece)
+{
+    if (unlikely(context->arenaUsed >= MCTS_ARENA_SIZE))
+        return -1;
+    MctsNode *node = &context->arena[context->arenaUsed];
+    node->parent = parent;
+    node->firstChild = -1;
+    node->childCount = 0;
+    node->cell = (int16_t)cell;
+    node->piece = (int8_t)piece;
+    node->outcome = 0;
+    node->visits = 0;
+    node->wins = 0;
+    return context->arenaUsed++;
+}
+
+// true if a piece sits within NEIGHBOUR_RADIUS of row, col
+static bool hasNeighbour(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int size, int row, int col)
+{
+    for (int r = max(0, row - NEIGHBOUR_RADIUS); r <= min(size - 1, row + NEIGHBOUR_RADIUS); r++)
+    {
+        for (int c = max(0, col - NEIGHBOUR_RADIUS); c <= min(size - 1, col + NEIGHBOUR_RADIUS); c++)
+        {
+            if (board[r][c] != BOARD_EMPTY)
+                return true;
+        }
+    }
+    return false;
+}
+
+// adds a child for every move of piece on board, all children are allocated in one block so they sit next to each other.
+// leaves the node unexpanded if the arena has no room for all of them.
+static void expandNode(MctsContext *context, int index, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int piece)
+{
+    int size = config.size;
+    bool restrictToNeighbours = size > FULL_WIDTH_MAX_SIZE;
+    int cells[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    int count = 0;
+    int emptyCount = 0;
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            if (board[row][col] != BOARD_EMPTY)
+                continue;
+            emptyCount++;
+            if (!restrictToNeighbours || hasNeighbour(board, size, row, col))
+                cells[count++] = row * size + col;
+        }
+    }
+    // nothing on the board yet, the center is as good as anything
+    if (count == 0 && emptyCount > 0)
+        cells[count++] = (size / 2) * size + size / 2;
+    if (count == 0 || context->arenaUsed + count > MCTS_ARENA_SIZE)
+        return;
+
+    MctsNode *arena = context->arena;
+    int first = context->arenaUsed;
+    for (int i = 0; i < count; i++)
+    {
+        int child = allocateNode(context, index, cells[i], piece);
+        int row = cells[i] / size;
+        int col = cells[i] % size;
+        board[row][col] = piece;
+        if (isWinningMove(board, config, row, col))
+            arena[child].outcome = 1;
+        else if (emptyCount == 1)
+            arena[child].outcome = 2;
+        board[row][col] = BOARD_EMPTY;
+    }
+    arena[index].firstChild = first;
+    arena[index].childCount = (int16_t)count;
+}
+
+// picks the child with the highest upper confidence bound, unvisited children first
+static int selectChild(MctsNode *arena, int index)
+{
+    MctsNode *node = &arena[index];
+    float logVisits = logf((float)node->visits);
+    int best = node->firstChild;
+    float bestScore = -1;
+    for (int i = node->firstChild; i < node->firstChild + node->childCount; i++)
+    {
+        MctsNode *child = &arena[i];
+        if (child->visits == 0)
+            return i;
+        float score = child->wins / child->visits + MCTS_EXPLORATION * sqrtf(logVisits / child->visits);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// plays uniformly random moves until someone wins or the board is full.
+// returns the winning piece, or BOARD_EMPTY for a draw.
+static int playout(MctsContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int piece)
+{
+    int size = config.size;
+    int empty[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    int count = 0;
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            if (board[row][col] == BOARD_EMPTY)
+                empty[count++] = row * size + col;
+        }
+    }
+
+    while (count > 0)
+    {
+        // swap the picked cell with the last one so the list stays packed
+        int pick = nextRandom(context) % count;
+        int cell = empty[pick];
+        empty[pick] = empty[--count];
+
+        int row = cell / size;
+        int col = cell % size;
+        board[row][col] = piece;
+        if (isWinningMove(board, config, row, col))
+            return piece;
+        piece = otherPiece(piece);
+    }
+    return BOARD_EMPTY;
+}
+
+Pair findBestMCTSMove(MctsContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType currentPlayer, bool playerStartFirst)
+{
+    Pair bestMove;
+    bestMove.a = -1;
+    bestMove.b = -1;
+    long long start = currentTimeMicros();
+    context->stats = (SearchStats){0};
+    if (!isMovesLeft(board, config))
+        return bestMove;
+
+    if (context->arena == NULL)
+    {
+        context->arena = malloc(sizeof(MctsNode) * MCTS_ARENA_SIZE);
+        // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+        if (unlikely(context->arena == NULL))
+        {
+            fprintf(stderr, "Memory allocation failed in findBestMCTSMove! This might be an Operating System Issue! Terminating.\n");
+            exit(1);
+        }
+    }
+    if (context->rngState == 0)
+        context->rngState = (uint64_t)currentTimeMillis() * 0x9E3779B97F4A7C15ull | 1;
+    MctsNode *arena = context->arena;
+
+    // X always starts, so whoever didn't start is O. the root "was played" by the human.
+    int aiPiece = playerStartFirst ? BOARD_NOUGHT : BOARD_CROSS;
+    context->arenaUsed = 0;
+    int root = allocateNode(context, -1, -1, otherPiece(aiPiece));
+    expandNode(context, root, board, config, aiPiece);
+
+    long long deadline = currentTimeMillis() + context->budgetMs;
+    int scratch[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+    while (context->playouts == 0 || context->stats.nodes < (unsigned long long)context->playouts)
+    {
+        // the clock is only read every 64 playouts, a playout takes a few microseconds at most
+        if ((context->stats.nodes & 63) == 0 && (currentTimeMillis() >= deadline || atomic_load(&context->cancelled)))
+            break;
+        memcpy(scratch, board, sizeof(scratch));
+
+        // selection, walk down the tree along the best upper confidence bounds
+        int index = root;
+        int depth = 0;
+        while (arena[index].childCount > 0 && arena[index].outcome == 0)
+        {
+            index = selectChild(arena, index);
+            scratch[arena[index].cell / config.size][arena[index].cell % config.size] = arena[index].piece;
+            depth++;
+        }
+
+        // expansion, a leaf gets its children the second time it is reached so one-off lines don't fill the arena
+        if (arena[index].outcome == 0 && arena[index].visits > 0)
+        {
+            expandNode(context, index, scratch, config, otherPiece(arena[index].piece));
+            if (arena[index].childCount > 0)
+            {
+                index = selectChild(arena, index);
+                scratch[arena[index].cell / config.size][arena[index].cell % config.size] = arena[index].piece;
+                depth++;
+            }
+        }
+        context->stats.maxDepth = max(context->stats.maxDepth, depth);
+
+        // simulation
+        int winner;
+        if (arena[index].outcome == 1)
+            winner = arena[index].piece;
+        else if (arena[index].outcome == 2)
+            winner = BOARD_EMPTY;
+        else
+            winner = playout(context, scratch, config, otherPiece(arena[index].piece));
+        context->stats.nodes++;
+
+        // backpropagation, every node scores the result for the piece that moved into it
+        for (; index >= 0; index = arena[index].parent)
+        {
+            arena[index].visits++;
+            if (winner == BOARD_EMPTY)
+                arena[index].wins += 0.5f;
+            else if (winner == arena[index].piece)
+                arena[index].wins += 1;
+        }
+    }
+
+    // the most visited move is the most robust choice, its value estimate is based on the most playouts
+    int bestChild = -1;
+    for (int i = arena[root].firstChild; i < arena[root].firstChild + arena[root].childCount; i++)
+    {
+        if (bestChild < 0 || arena[i].visits > arena[bestChild].visits)
+            bestChild = i;
+    }
+    if (bestChild >= 0)
+    {
+        bestMove.a = arena[bestChild].cell / config.size;
+        bestMove.b = arena[bestChild].cell % config.size;
+    }
+    context->stats.timeMs = (currentTimeMicros() - start) / 1000.0;
+    return bestMove;
+}
@@ -1,104 +1,253 @@
+#include <string.h>
 #include <include/minimax.h>
 #include <include/definitions.h>
-// set max depth default value here, but it can be modified by tui.c and gui.c
-int MAX_DEPTH = 2;
+#include <include/move_table.h>
+#include <include/game.h>
+#include <include/opening_book.h>
+#include <include/solved_database.h>
 
-int evaluateBoard(int board[3][3])
+SearchContext *createSearchContext(int maxDepth, int threads)
 {
-    // Check rows
-    for (int i = 0; i < 3; i++)
+    SearchContext *context = malloc(sizeof(SearchContext));
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if (unlikely(context == NULL))
     {
-        if (board[i][0] == board[i][1] && board[i][1] == board[i][2])
-        {
-            if (board[i][0] == 1)
-                return 10; // Player A wins
-            if (board[i][0] == 2)
-                return -10; // Player B (AI) wins
-        }
+        fprintf(stderr, "Memory allocation failed in createSearchContext! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
     }
+    context->maxDepth = maxDepth;
+    context->threads = threads;
+    context->stats = (SearchStats){0};
+    atomic_init(&context->cancelled, false);
+    context->table = NULL;
+    context->sharedTable = NULL;
+    context->pool = NULL;
+    context->threadSearches = NULL;
+    context->lines = NULL;
+    context->book = NULL;
+    context->database = NULL;
+    return context;
+}
+
+void destroySearchContext(SearchContext *context)
+{
+    if (context == NULL)
+        return;
+    destroyThreadPool(context->pool);
+    free(context->threadSearches);
+    destroyTranspositionTable(context->table);
+    destroySharedTranspositionTable(context->sharedTable);
+    free(context->lines);
+    free(context);
+}
+
+void cancelSearch(SearchContext *context)
+{
+    atomic_store(&context->cancelled, true);
+}
 
-    // Check columns
-    for (int j = 0; j < 3; j++)
+void resetSearchCancel(SearchContext *context)
+{
+    atomic_store(&context->cancelled, false);
+}
+
+static inline bool isCancelled(SearchContext *context)
+{
+    return atomic_load_explicit(&context->cancelled, memory_order_relaxed);
+}
+
+// fills moves with the empty cells of the board, hashCell first, then previousCell, then CLASSIC_MOVE_ORDER.
+// either of the two may be -1 when there is nothing to try first. returns the number of moves.
+static int orderMoves(uint16_t occupied, int hashCell, int previousCell, int moves[9])
+{
+    int count = 0;
+    if (hashCell >= 0 && !(occupied & (1u << hashCell)))
+        moves[count++] = hashCell;
+    if (previousCell >= 0 && previousCell != hashCell && !(occupied & (1u << previousCell)))
+        moves[count++] = previousCell;
+    for (int i = 0; i < 9; i++)
     {
-        if (board[0][j] == board[1][j] && board[1][j] == board[2][j])
-        {
-            if (board[0][j] == 1)
-                return 10;
-            if (board[0][j] == 2)
-                return -10;
-        }
+        int cell = CLASSIC_MOVE_ORDER[i];
+        if (cell != hashCell && cell != previousCell && !(occupied & (1u << cell)))
+            moves[count++] = cell;
     }
+    return count;
+}
+
+// Wins of the classic search are worth (10 - depth) * CLASSIC_SCORE_SCALE, leaving room below the latest possible win
+// for the score at the horizon. The largest win still fits the int8_t value of the transposition table.
+#define CLASSIC_SCORE_SCALE 12
+// Positions at the horizon score at most this much either way, short of any win.
+#define CLASSIC_PATTERN_LIMIT (CLASSIC_SCORE_SCALE - 1)
+// Worth of a line only one side holds, by the number of its pieces in it. Each piece more is worth 4 times as much,
+// like LINE_PATTERN_WEIGHTS.
+static const int CLASSIC_PATTERN_WEIGHTS[3] = {0, 1, 4};
 
-    // Check diagonals
-    if ((board[0][0] == board[1][1] && board[1][1] == board[2][2]) ||
-        (board[0][2] == board[1][1] && board[1][1] == board[2][0]))
+int evaluateBoard(Bitboard board)
+{
+    // a single mask test per line replaces the row, column and diagonal scans
+    if (hasWinningLine(board.cross))
+        return 10; // Player A wins
+    if (hasWinningLine(board.nought))
+        return -10; // Player B (AI) wins
+
+    return 0; // No winner yet
+}
+
+// score of a position the classic search doesn't look past, positive when it favours the AI's crosses. the side to
+// move wins if one of its lines is a piece short, and two such lines of the other side are nearly as good for that
+// side. anything else weighs the lines each side holds alone, kept below the latest win so it never passes for one.
+static int evaluateClassicHorizon(Bitboard board, int depth, bool crossToMove)
+{
+    int score = 0;
+    int threats[2] = {0, 0};
+    for (int i = 0; i < WIN_LINE_COUNT; i++)
     {
-        if (board[1][1] == 1)
-            return 10;
-        if (board[1][1] == 2)
-            return -10;
+        int crosses = BIT_COUNTS[board.cross & WIN_LINES[i]];
+        int noughts = BIT_COUNTS[board.nought & WIN_LINES[i]];
+        // a line holding both pieces is blocked and worth nothing to either side
+        if (noughts == 0)
+        {
+            score += CLASSIC_PATTERN_WEIGHTS[crosses];
+            threats[0] += crosses == 2;
+        }
+        if (crosses == 0)
+        {
+            score -= CLASSIC_PATTERN_WEIGHTS[noughts];
+            threats[1] += noughts == 2;
+        }
     }
 
-    return 0; // No winner yet
+    int toMove = crossToMove ? 0 : 1;
+    int sign = crossToMove ? 1 : -1;
+    if (threats[toMove] > 0)
+        return sign * (10 - depth - 1) * CLASSIC_SCORE_SCALE; // the win one move later
+    if (threats[toMove ^ 1] > 1)
+        return -sign * CLASSIC_PATTERN_LIMIT;
+    return min(max(score, -CLASSIC_PATTERN_LIMIT), CLASSIC_PATTERN_LIMIT);
 }
 
-int minimax(int board[3][3], int depth, bool isMaximizing, PlayerType currentPlayer)
+int minimax(SearchContext *context, Bitboard board, int depth, int alpha, int beta, bool isMaximizing, PlayerType currentPlayer)
 {
+    context->stats.nodes++;
+    // depth starts at 0 one move below the position findBestMove was asked about
+    if (depth + 1 > context->stats.maxDepth)
+        context->stats.maxDepth = depth + 1;
     int score = evaluateBoard(board);
 
     if (score == 10)
     {
-        return score - depth; // Player A wins (minimize depth)
+        return (score - depth) * CLASSIC_SCORE_SCALE; // AI wins (maximize, sooner is better)
     }
     if (score == -10)
     {
-        return score + depth; // Player B (AI) wins (maximize depth)
+        return (score + depth) * CLASSIC_SCORE_SCALE; // Player wins (minimize, sooner is better)
     }
 
-    if (!isMovesLeft(board) || depth >= MAX_DEPTH)
+    // once every line holds both pieces nobody can win anymore, which includes the full board.
+    // a cancelled search is thrown away, so any value will do
+    if (isBitboardDeadDraw(board) || isCancelled(context))
     {
         return 0; // Draw
     }
 
-    if (isMaximizing)
-    { // AI's turn (Player B)
-        int best = -1000;
-        for (int i = 0; i < 3; i++)
+    // the AI places crosses (1) and the player noughts (2)
+    bool placeCross = currentPlayer != PLAYER_1;
+    if (depth >= context->maxDepth)
+    {
+        return evaluateClassicHorizon(board, depth, placeCross);
+    }
+
+    // all 8 rotations and reflections of a position have the same value, so they share one entry
+    int symmetry;
+    uint32_t key = bitboardKey(canonicalBitboard(board, &symmetry));
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int hashCell = -1;
+    TTEntry entry;
+    if (probeTranspositionTable(context->table, key, &entry))
+    {
+        context->stats.hashHits++;
+        if (entry.bound == BOUND_EXACT)
+            return entry.value;
+        if (entry.bound == BOUND_LOWER)
+            alpha = max(alpha, entry.value);
+        else
+            beta = min(beta, entry.value);
+        if (alpha >= beta)
         {
-            for (int j = 0; j < 3; j++)
-            {
-                if (board[i][j] == 0)
-                {
-                    board[i][j] = (currentPlayer == PLAYER_1) ? 1 : 2; // AI's symbol
-                    best = max(best, minimax(board, depth + 1, !isMaximizing,
-                                             (currentPlayer == PLAYER_1) ? AI : PLAYER_1));
-                    board[i][j] = 0;
-                }
-            }
+            context->stats.cutoffs++;
+            return entry.value;
         }
-        return best;
+
+        // the stored move is in canonical coordinates, map it back onto this board
+        if (entry.bestCell >= 0)
+            hashCell = SYMMETRY_CELLS[INVERSE_SYMMETRY[symmetry]][entry.bestCell];
     }
-    else
-    { // Human player's turn (Player A)
-        int best = 1000;
-        for (int i = 0; i < 3; i++)
+
+    PlayerType nextPlayer = (currentPlayer == PLAYER_1) ? AI : PLAYER_1;
+    // the cell that was best the last time a node at this depth was searched, siblings tend to share it so it is tried first.
+    // depth can go one below zero because findBestMove searches the root moves itself, hence the offset of 1.
+    int *slot = &context->previousBest[depth + 1];
+    int moves[9];
+    int moveCount = orderMoves(occupiedCells(board), hashCell, *slot, moves);
+
+    int best = isMaximizing ? -1000 : 1000;
+    int bestCell = -1;
+    for (int i = 0; i < moveCount; i++)
+    {
+        uint16_t bit = (uint16_t)(1u << moves[i]);
+
+        // the child board is a copy so there is nothing to undo
+        Bitboard child = board;
+        if (placeCross)
+            child.cross |= bit;
+        else
+            child.nought |= bit;
+
+        int value = minimax(context, child, depth + 1, alpha, beta, !isMaximizing, nextPlayer);
+        if (isMaximizing ? value > best : value < best)
         {
-            for (int j = 0; j < 3; j++)
-            {
-                if (board[i][j] == 0)
-                {
-                    board[i][j] = (currentPlayer == PLAYER_1) ? 1 : 2; // Human's symbol
-                    best = min(best, minimax(board, depth + 1, !isMaximizing,
-                                             (currentPlayer == PLAYER_1) ? AI : PLAYER_1));
-                    board[i][j] = 0;
-                }
-            }
+            best = value;
+            bestCell = moves[i];
+        }
+
+        if (isMaximizing)
+            alpha = max(alpha, best);
+        else
+            beta = min(beta, best);
+
+        // the other player already has a better option elsewhere, so this node can't change the result
+        if (alpha >= beta)
+        {
+            context->stats.cutoffs++;
+            break;
         }
-        return best;
     }
+    *slot = bestCell;
+
+    BoundType bound = BOUND_EXACT;
+    if (best <= alphaOrig)
+        bound = BOUND_UPPER;
+    else if (best >= betaOrig)
+        bound = BOUND_LOWER;
+    storeTranspositionTable(context->table, key, best, bound, SYMMETRY_CELLS[symmetry][bestCell]);
+    return best;
 }
 
-Pair findBestMove(int board[3][3], PlayerType currentPlayer, bool playerStartFirst)
+Pair findTableMove(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], PlayerType currentPlayer, bool playerStartFirst)
+{
+    // the table works on the real X/O board and knows whose turn it is from the piece counts,
+    // so no conversion is needed and currentPlayer/playerStartFirst are unused.
+    MoveTableEntry entry = MOVE_TABLE[positionIndex(boardToBitboard(board))];
+    Pair bestMove;
+    bestMove.a = entry.move < 0 ? -1 : entry.move / 3;
+    bestMove.b = entry.move < 0 ? -1 : entry.move % 3;
+    return bestMove;
+}
+
+// root of the bitboard search for the classic 3x3 game
+static Pair findClassicMove(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], PlayerType currentPlayer, bool playerStartFirst)
 {
     int bestVal = -1000;
     Pair bestMove;
@@ -107,38 +256,774 @@ Pair findBestMove(int board[3][3], PlayerType currentPlayer, bool playerStartFir
 
     bool isMaximizing = false;
 
-    if(!playerStartFirst){
+    Bitboard position = boardToBitboard(board);
+    if(playerStartFirst){
         // convert the board state to something understandable by minimax
-        // minimax only sees 1 as player and 2 as AI, so just change it as such.
-        for (int i = 0; i < 3; i++)
+        // minimax sees the AI as crosses (1) and the player as noughts (2), so just swap the two masks.
+        uint16_t t = position.cross;
+        position.cross = position.nought;
+        position.nought = t;
+    }
+
+    context->stats = (SearchStats){0};
+    if (context->table == NULL)
+        context->table = createTranspositionTable(TRANSPOSITION_TABLE_SIZE);
+    newSearchGeneration(context->table);
+    for (int i = 0; i < CLASSIC_MAX_DEPTH + 2; i++)
+        context->previousBest[i] = -1;
+
+    bool placeCross = currentPlayer != PLAYER_1; // AI's symbol
+    int bestCell = 9;
+    for (int i = 0; i < 9; i++)
+    {
+        int cell = CLASSIC_MOVE_ORDER[i];
+        uint16_t bit = (uint16_t)(1u << cell);
+        if (occupiedCells(position) & bit)
+            continue;
+
+        Bitboard child = position;
+        if (placeCross)
+            child.cross |= bit;
+        else
+            child.nought |= bit;
+
+        // ties go to the first cell in row-major order like the old unordered loop did,
+        // so for a cell before the current best the window is widened by one to see an equal score exactly.
+        int alpha = cell < bestCell ? bestVal - 1 : bestVal;
+        int moveVal = minimax(context, child, 0, alpha, 1000, isMaximizing, (currentPlayer == PLAYER_1) ? AI : PLAYER_1);
+        if (isCancelled(context))
         {
-            for (int j = 0; j < 3; j++)
-            {
-                if(board[i][j] != BOARD_EMPTY){
-                    board[i][j] = board[i][j] == BOARD_NOUGHT ? 1 : 2;
-                }
-            }
+            bestMove.a = -1;
+            bestMove.b = -1;
+            break;
+        }
+
+        if (moveVal > bestVal || (moveVal == bestVal && cell < bestCell))
+        {
+            bestMove.a = cell / 3;
+            bestMove.b = cell % 3;
+            bestVal = moveVal;
+            bestCell = cell;
         }
     }
+    return bestMove;
+}
 
-    for (int i = 0; i < 3; i++)
+// Score of a win on a generic board, minus the depth it happens at so quicker wins are preferred.
+#define WIN_SCORE 1000
+// Positions at the search horizon score at most this much either way, well clear of the win scores.
+#define PATTERN_SCORE_LIMIT (WIN_SCORE / 2 - 1)
+// Larger than any score, used as the initial alpha-beta window.
+#define INFINITE_SCORE 100000
+// Cutoff moves remembered per ply, tried right after the hash move by every other node at that ply.
+#define KILLER_SLOTS 2
+// A side's history scores are halved once one passes this, so they stay in an int and old cutoffs fade out.
+#define HISTORY_LIMIT (1 << 24)
+// Cutoffs closer to the leaves than this don't count towards the history, there are so many of them they drown out the ones that matter.
+#define HISTORY_MIN_REMAINING 4
+
+/// @brief State of a search on a generic size x size board, the board is modified in place and restored on the way back up.
+typedef struct BoardSearch{
+    SearchContext *context;
+    int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+    BoardConfig config;
+    int aiPiece;
+    int humanPiece;
+    int movesLeft; // number of empty cells
+    int order[MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // cells as row * size + col, closest to the center first
+    bool restrictToNeighbours;
+    int neighbours[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; // number of pieces within NEIGHBOUR_RADIUS, only kept when restrictToNeighbours
+    uint64_t hash; // Zobrist key of board, see zobristKey
+    const LineTable *lines; // lines of the board, generated for the presets, otherwise owned by the context
+    LineCounts lineCounts; // pieces in every line of board, for wins, dead draws and the score at the horizon
+    int16_t killers[MAX_BOARD_SIZE * MAX_BOARD_SIZE][KILLER_SLOTS]; // per ply below the root, the latest cells that caused a cutoff there, -1 for none
+    int history[2][MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // per side (X, O) and cell, the remaining depth squared of every cutoff it caused
+    uint8_t ring[MAX_BOARD_SIZE * MAX_BOARD_SIZE]; // distance of every cell to the center, history only reorders cells of the same ring
+    int depthLimit; // positions at this depth are scored by evaluateHorizon from the line patterns
+    long long deadline; // currentTimeMillis() at which the search gives up, 0 for no time limit
+    bool aborted; // set once the deadline has passed or the search was cancelled, every node returns straight away after that
+    SearchStats stats; // what this copy of the search visited, added to the context's stats at the end
+}BoardSearch;
+
+// sorts the cells by distance to the center, cells in the middle sit on the most lines so they are searched first.
+// the presets take the same order from PRESET_CENTER_ORDERS, this is for any other board
+static void computeCenterOrder(BoardSearch *search)
+{
+    int size = search->config.size;
+    int distance[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    int cellCount = size * size;
+    for (int cell = 0; cell < cellCount; cell++)
+    {
+        // doubled coordinates keep the center of even sized boards on integers
+        int dr = abs(2 * (cell / size) - (size - 1));
+        int dc = abs(2 * (cell % size) - (size - 1));
+        distance[cell] = max(dr, dc) * 4 * MAX_BOARD_SIZE + dr + dc;
+
+        // insertion sort, stable so equal distances stay in row-major order
+        int i = cell;
+        while (i > 0 && distance[search->order[i - 1]] > distance[cell])
+        {
+            search->order[i] = search->order[i - 1];
+            i--;
+        }
+        search->order[i] = cell;
+    }
+}
+
+static void updateNeighbours(BoardSearch *search, int row, int col, int delta)
+{
+    int size = search->config.size;
+    for (int r = max(0, row - NEIGHBOUR_RADIUS); r <= min(size - 1, row + NEIGHBOUR_RADIUS); r++)
+    {
+        for (int c = max(0, col - NEIGHBOUR_RADIUS); c <= min(size - 1, col + NEIGHBOUR_RADIUS); c++)
+        {
+            search->neighbours[r][c] += delta;
+        }
+    }
+}
+
+static inline void placePiece(BoardSearch *search, int row, int col, int piece)
+{
+    search->board[row][col] = piece;
+    search->hash ^= zobristKey(row * MAX_BOARD_SIZE + col, piece);
+    addLinePiece(search->lines, &search->lineCounts, row * MAX_BOARD_SIZE + col, piece == BOARD_CROSS ? 0 : 1);
+    search->movesLeft--;
+    if (search->restrictToNeighbours)
+        updateNeighbours(search, row, col, 1);
+}
+
+static inline void removePiece(BoardSearch *search, int row, int col)
+{
+    int piece = search->board[row][col];
+    search->hash ^= zobristKey(row * MAX_BOARD_SIZE + col, piece);
+    removeLinePiece(search->lines, &search->lineCounts, row * MAX_BOARD_SIZE + col, piece == BOARD_CROSS ? 0 : 1);
+    search->board[row][col] = BOARD_EMPTY;
+    search->movesLeft++;
+    if (search->restrictToNeighbours)
+        updateNeighbours(search, row, col, -1);
+}
+
+static inline bool isCandidate(BoardSearch *search, int row, int col)
+{
+    return search->board[row][col] == BOARD_EMPTY && (!search->restrictToNeighbours || search->neighbours[row][col] > 0);
+}
+
+// a cell on dead lines only can't win or block anything, playing there is as good as passing.
+// any piece on an open line is worth at least that much, and there is one as long as a line is open.
+static inline bool isSearchMove(BoardSearch *search, int cell)
+{
+    int size = search->config.size;
+    int row = cell / size;
+    int col = cell % size;
+    return isCandidate(search, row, col) && search->lineCounts.cellOpenLines[row * MAX_BOARD_SIZE + col] > 0;
+}
+
+// fills moves with the first cells to search at depth, the hash move and then the killers of this ply.
+// returns the number of moves.
+static int firstBoardMoves(BoardSearch *search, int depth, int hashCell, int *moves)
+{
+    const int16_t *killers = search->killers[depth];
+    int count = 0;
+    if (hashCell >= 0 && isSearchMove(search, hashCell))
+        moves[count++] = hashCell;
+    for (int k = 0; k < KILLER_SLOTS; k++)
+    {
+        int cell = killers[k];
+        if (cell >= 0 && cell != hashCell && isSearchMove(search, cell))
+            moves[count++] = cell;
+    }
+    return count;
+}
+
+// appends up to limit more cells to moves in the center-out order, skipping the ones firstBoardMoves took.
+// *next is where the last call stopped in search->order. returns the new number of moves.
+static int moreBoardMoves(BoardSearch *search, int depth, int hashCell, int *moves, int count, int *next, int limit)
+{
+    int cellCount = search->config.size * search->config.size;
+    const int16_t *killers = search->killers[depth];
+    int end = count + limit;
+    while (count < end && *next < cellCount)
     {
-        for (int j = 0; j < 3; j++)
+        int cell = search->order[(*next)++];
+        if (cell != hashCell && cell != killers[0] && cell != killers[1] && isSearchMove(search, cell))
+            moves[count++] = cell;
+    }
+    return count;
+}
+
+// sorts moves[from..count) by history, highest first. a cell that caused cutoffs elsewhere is no reason to search it
+// before the cells closer to the center, that made the search larger on every board tried, so only cells of the
+// same ring change places and the center-out order stays otherwise. insertion sort, stable so equal scores keep their
+// order, and as good as a single pass over moves that already come in center-out order when most scores are 0.
+static void sortByHistory(const BoardSearch *search, const int *history, int *moves, int from, int count)
+{
+    for (int i = from + 1; i < count; i++)
+    {
+        int cell = moves[i];
+        int j = i;
+        while (j > from && search->ring[moves[j - 1]] == search->ring[cell] && history[moves[j - 1]] < history[cell])
         {
-            if (board[i][j] == 0)
+            moves[j] = moves[j - 1];
+            j--;
+        }
+        moves[j] = cell;
+    }
+}
+
+// remembers a move that caused a cutoff, as a killer of its ply and in the history of the side that played it
+static void recordCutoff(BoardSearch *search, int depth, int side, int cell, int hashCell, int remaining)
+{
+    // the hash move is tried first anyway, a killer slot is better spent on another move
+    int16_t *killers = search->killers[depth];
+    if (cell != hashCell && killers[0] != cell)
+    {
+        killers[1] = killers[0];
+        killers[0] = (int16_t)cell;
+    }
+
+    if (remaining < HISTORY_MIN_REMAINING)
+        return;
+    int *history = search->history[side];
+    history[cell] += remaining * remaining;
+    if (history[cell] > HISTORY_LIMIT)
+    {
+        for (int i = 0; i < MAX_BOARD_SIZE * MAX_BOARD_SIZE; i++)
+            history[i] /= 2;
+    }
+}
+
+// checks the clock every 256 nodes, often enough to stop within a fraction of a millisecond without paying for a system call per node
+static inline bool isOutOfTime(BoardSearch *search)
+{
+    if ((search->stats.nodes & 255) == 0)
+    {
+        if (isCancelled(search->context) || (search->deadline != 0 && currentTimeMillis() >= search->deadline))
+            search->aborted = true;
+    }
+    return search->aborted;
+}
+
+// win scores depend on the distance from the root, the table stores them relative to the position instead
+// so they stay valid when the same position comes up at another depth
+static inline int scoreToTable(int value, int depth)
+{
+    if (value > WIN_SCORE / 2)
+        return value + depth;
+    if (value < -WIN_SCORE / 2)
+        return value - depth;
+    return value;
+}
+
+static inline int scoreFromTable(int value, int depth)
+{
+    if (value > WIN_SCORE / 2)
+        return value - depth;
+    if (value < -WIN_SCORE / 2)
+        return value + depth;
+    return value;
+}
+
+// score of a position the search doesn't look past, from the AI's point of view. the side to move wins if it can
+// complete a line with its next piece. two lines the other side could complete are nearly as good for that side,
+// short of a win only because both may need the same cell. anything else is the pattern score, the lines either
+// side holds alone weighted by how close they are to complete, kept below the win scores so it never passes for one.
+static int evaluateHorizon(BoardSearch *search, int depth, bool isMaximizing)
+{
+    const LineCounts *lines = &search->lineCounts;
+    int aiSide = search->aiPiece == BOARD_CROSS ? 0 : 1;
+    int toMove = isMaximizing ? aiSide : aiSide ^ 1;
+    int sign = isMaximizing ? 1 : -1;
+    if (lines->threats[toMove] > 0)
+        return sign * (WIN_SCORE - depth - 1);
+    if (lines->threats[toMove ^ 1] > 1)
+        return -sign * PATTERN_SCORE_LIMIT;
+    int score = aiSide == 0 ? lines->patternScore : -lines->patternScore;
+    return min(max(score, -PATTERN_SCORE_LIMIT), PATTERN_SCORE_LIMIT);
+}
+
+// minimax with alpha-beta on a generic board. lastRow, lastCol is the move that led here, the only one that can have won.
+// results go to the shared transposition table, so every search thread profits from what the others found.
+static int minimaxBoard(BoardSearch *search, int depth, int alpha, int beta, bool isMaximizing, int lastRow, int lastCol)
+{
+    search->stats.nodes++;
+    // depth starts at 0 one move below the root
+    if (depth + 1 > search->stats.maxDepth)
+        search->stats.maxDepth = depth + 1;
+    // the result is thrown away once the search has run out of time, so any value will do
+    if (isOutOfTime(search))
+        return 0;
+
+    // the root is never won already, so a completed line can only come from the move that led here
+    bool won = search->lineCounts.completedLines > 0;
+    if (won)
+    {
+        // AI wins (maximize) or the player wins (minimize), sooner is better for the winner
+        return search->board[lastRow][lastCol] == search->aiPiece ? WIN_SCORE - depth : -WIN_SCORE + depth;
+    }
+
+    // nobody can win once every line holds both pieces, no need to play it out. a full board always gets here.
+    bool deadDraw = search->lineCounts.openLines == 0;
+    if (deadDraw)
+    {
+        return 0; // Draw
+    }
+    if (depth >= search->depthLimit)
+    {
+        return evaluateHorizon(search, depth, isMaximizing);
+    }
+
+    // side to move follows from the pieces on the board, so the key alone identifies the node
+    int remaining = search->depthLimit - depth;
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int hashCell = -1;
+    SharedTTEntry entry;
+    if (probeSharedTable(search->context->sharedTable, search->hash, &entry))
+    {
+        search->stats.hashHits++;
+        // a shallower result still orders the moves, but its value can't be trusted this deep
+        if (entry.depth >= remaining)
+        {
+            int value = scoreFromTable(entry.value, depth);
+            if (entry.bound == BOUND_EXACT)
+                return value;
+            if (entry.bound == BOUND_LOWER)
+                alpha = max(alpha, value);
+            else
+                beta = min(beta, value);
+            if (alpha >= beta)
             {
-                board[i][j] = (currentPlayer == PLAYER_1) ? 2 : 1; // AI's symbol
-                int moveVal = minimax(board, 0, isMaximizing, (currentPlayer == PLAYER_1) ? AI : PLAYER_1);
-                board[i][j] = 0;
-
-                if (moveVal > bestVal)
-                {
-                    bestMove.a = i;
-                    bestMove.b = j;
-                    bestVal = moveVal;
-                }
+                search->stats.cutoffs++;
+                return value;
             }
         }
+        hashCell = entry.bestCell;
     }
-    return bestMove;
-}
\ No newline at end of file
+
+    int size = search->config.size;
+    int piece = isMaximizing ? search->aiPiece : search->humanPiece;
+    int side = piece == BOARD_CROSS ? 0 : 1;
+    int best = isMaximizing ? -INFINITE_SCORE : INFINITE_SCORE;
+    int bestCell = -1;
+    int moves[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    int moveCount = firstBoardMoves(search, depth, hashCell, moves);
+    int next = 0;
+    // the children of the last ply are scored without searching any further, so their order hardly matters and most
+    // of these nodes cut off early. their other moves are taken one at a time, the deeper nodes sort them all by history.
+    if (remaining >= 2)
+    {
+        int first = moveCount;
+        moveCount = moreBoardMoves(search, depth, hashCell, moves, moveCount, &next, size * size);
+        sortByHistory(search, search->history[side], moves, first, moveCount);
+    }
+    for (int i = 0;; i++)
+    {
+        if (i == moveCount)
+            moveCount = moreBoardMoves(search, depth, hashCell, moves, moveCount, &next, 1);
+        if (i == moveCount)
+            break;
+        int cell = moves[i];
+        int row = cell / size;
+        int col = cell % size;
+
+        placePiece(search, row, col, piece);
+        int value = minimaxBoard(search, depth + 1, alpha, beta, !isMaximizing, row, col);
+        removePiece(search, row, col);
+
+        if (isMaximizing ? value > best : value < best)
+        {
+            best = value;
+            bestCell = cell;
+        }
+
+        if (isMaximizing)
+            alpha = max(alpha, best);
+        else
+            beta = min(beta, best);
+
+        if (alpha >= beta)
+        {
+            search->stats.cutoffs++;
+            recordCutoff(search, depth, side, cell, hashCell, remaining);
+            break;
+        }
+    }
+
+    // an aborted subtree returned garbage, keep it out of the table
+    if (search->aborted)
+        return best;
+    // the open lines are all out of the neighbour restriction's reach, nothing within it changes the outcome
+    if (bestCell < 0)
+        return 0;
+
+    BoundType bound = BOUND_EXACT;
+    if (best <= alphaOrig)
+        bound = BOUND_UPPER;
+    else if (best >= betaOrig)
+        bound = BOUND_LOWER;
+    storeSharedTable(search->context->sharedTable, search->hash, scoreToTable(best, depth), bound, remaining, bestCell);
+    return best;
+}
+
+// copies the board into the search and sets up the move order and neighbour counts
+static void initBoardSearch(SearchContext *context, BoardSearch *search, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, bool playerStartFirst)
+{
+    int size = config.size;
+    search->context = context;
+    search->config = config;
+    // X always starts, so whoever didn't start is O
+    search->aiPiece = playerStartFirst ? BOARD_NOUGHT : BOARD_CROSS;
+    search->humanPiece = playerStartFirst ? BOARD_CROSS : BOARD_NOUGHT;
+    search->restrictToNeighbours = size > FULL_WIDTH_MAX_SIZE;
+    search->movesLeft = 0;
+    search->hash = 0;
+    search->depthLimit = context->maxDepth;
+    search->deadline = 0;
+    search->aborted = false;
+    search->stats = (SearchStats){0};
+    memset(search->killers, 0xFF, sizeof(search->killers));
+    memset(search->history, 0, sizeof(search->history));
+    int preset = boardPresetIndex(config);
+    if (preset >= 0)
+    {
+        for (int i = 0; i < size * size; i++)
+            search->order[i] = PRESET_CENTER_ORDERS[preset][i];
+    }
+    else
+        computeCenterOrder(search);
+    // the first key of the center-out order, in the same doubled coordinates
+    for (int cell = 0; cell < size * size; cell++)
+        search->ring[cell] = (uint8_t)max(abs(2 * (cell / size) - (size - 1)), abs(2 * (cell % size) - (size - 1)));
+
+    // the presets have generated line tables, any other board builds its own and keeps it until a search on another board
+    search->lines = presetLineTable(config);
+    if (search->lines == NULL && context->lines == NULL)
+    {
+        context->lines = malloc(sizeof(LineTable));
+        // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+        if (unlikely(context->lines == NULL))
+        {
+            fprintf(stderr, "Memory allocation failed in initBoardSearch! This might be an Operating System Issue! Terminating.\n");
+            exit(1);
+        }
+        context->lines->lineCount = 0;
+    }
+    if (search->lines == NULL)
+    {
+        if (context->lines->lineCount == 0 || context->lines->config.size != config.size || context->lines->config.winLength != config.winLength)
+            buildLineTable(config, context->lines);
+        search->lines = context->lines;
+    }
+    clearLineCounts(search->lines, &search->lineCounts);
+
+    // scores are relative to this root and depend on which side the AI plays, so nothing carries over from the last move
+    if (context->sharedTable == NULL)
+        context->sharedTable = createSharedTranspositionTable(SHARED_TRANSPOSITION_TABLE_SIZE);
+    newSharedSearchGeneration(context->sharedTable);
+
+    for (int i = 0; i < MAX_BOARD_SIZE; i++)
+    {
+        for (int j = 0; j < MAX_BOARD_SIZE; j++)
+        {
+            search->board[i][j] = BOARD_EMPTY;
+            search->neighbours[i][j] = 0;
+        }
+    }
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            search->movesLeft++;
+            if (board[i][j] != BOARD_EMPTY)
+                placePiece(search, i, j, board[i][j]);
+        }
+    }
+}
+
+/// @brief Root moves handed out to the search threads, see searchRootMoves.
+typedef struct RootSplit{
+    BoardSearch *searches; // one copy of the search per thread
+    int moves[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    int moveCount;
+    atomic_int nextMove; // index of the next move nobody has taken yet
+    pthread_mutex_t lock; // guards bestVal and bestIndex
+    int bestVal;
+    int bestIndex; // index into moves, moveCount while nothing has been searched
+}RootSplit;
+
+// run by every thread of the pool, each thread keeps taking the next unsearched root move until none are left.
+// every move is searched with the best score found so far by any thread as alpha, so later moves get cut off just like serially.
+// ties go to the earlier move like in a single threaded search, whichever thread finishes first, so a move before
+// the current best gets its window widened by one to see an equal score exactly.
+static void searchRootMoves(void *arg, int threadIndex)
+{
+    RootSplit *split = arg;
+    BoardSearch *search = &split->searches[threadIndex];
+    int size = search->config.size;
+    while (!search->aborted)
+    {
+        int i = atomic_fetch_add(&split->nextMove, 1);
+        if (i >= split->moveCount)
+            break;
+        int row = split->moves[i] / size;
+        int col = split->moves[i] % size;
+
+        pthread_mutex_lock(&split->lock);
+        int alpha = i < split->bestIndex ? split->bestVal - 1 : split->bestVal;
+        pthread_mutex_unlock(&split->lock);
+
+        placePiece(search, row, col, search->aiPiece);
+        int moveVal = minimaxBoard(search, 0, alpha, INFINITE_SCORE, false, row, col);
+        removePiece(search, row, col);
+
+        if (search->aborted)
+            break;
+
+        pthread_mutex_lock(&split->lock);
+        if (moveVal > split->bestVal || (moveVal == split->bestVal && i < split->bestIndex))
+        {
+            split->bestVal = moveVal;
+            split->bestIndex = i;
+        }
+        pthread_mutex_unlock(&split->lock);
+    }
+}
+
+void addSearchStats(SearchStats *total, const SearchStats *stats)
+{
+    total->nodes += stats->nodes;
+    total->maxDepth = max(total->maxDepth, stats->maxDepth);
+    total->cutoffs += stats->cutoffs;
+    total->hashHits += stats->hashHits;
+}
+
+// makes sure the context's pool has context->threads threads, rebuilding it when the setting changed since the last search
+static void prepareSearchThreads(SearchContext *context)
+{
+    int threadCount = max(1, context->threads);
+    if (context->pool != NULL && context->pool->threadCount == threadCount)
+        return;
+
+    destroyThreadPool(context->pool);
+    free(context->threadSearches);
+    context->pool = createThreadPool(threadCount);
+    context->threadSearches = malloc(sizeof(BoardSearch) * threadCount);
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if (unlikely(context->threadSearches == NULL))
+    {
+        fprintf(stderr, "Memory allocation failed in prepareSearchThreads! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+}
+
+ThreadPool *searchThreadPool(SearchContext *context)
+{
+    prepareSearchThreads(context);
+    return context->pool;
+}
+
+// searches every root move to search->depthLimit, trying firstCell (row * size + col, -1 for none) before the others.
+// the moves are split between the context's threads, all sharing its shared transposition table.
+// returns the best cell, or -1 if there is no move or the search ran out of time before finishing.
+static int searchBoardRoot(BoardSearch *search, int firstCell, int *bestValue)
+{
+    int size = search->config.size;
+
+    // nothing on the board yet, so no neighbours either. the center is as good as anything.
+    if (search->movesLeft == size * size)
+    {
+        *bestValue = 0;
+        return search->order[0];
+    }
+
+    RootSplit split;
+    split.moveCount = 0;
+    // index -1 is firstCell, the rest follows the center-out order and skips it
+    for (int i = -1; i < size * size; i++)
+    {
+        int cell = i < 0 ? firstCell : search->order[i];
+        if (cell < 0 || (i >= 0 && cell == firstCell))
+            continue;
+        if (isCandidate(search, cell / size, cell % size))
+            split.moves[split.moveCount++] = cell;
+    }
+    atomic_store(&split.nextMove, 0);
+    split.bestVal = -INFINITE_SCORE;
+    split.bestIndex = split.moveCount;
+
+    SearchContext *context = search->context;
+    prepareSearchThreads(context);
+    split.searches = context->threadSearches;
+    for (int t = 0; t < context->pool->threadCount; t++)
+    {
+        split.searches[t] = *search;
+        split.searches[t].stats = (SearchStats){0};
+    }
+    pthread_mutex_init(&split.lock, NULL);
+    runThreadPool(context->pool, searchRootMoves, &split);
+    pthread_mutex_destroy(&split.lock);
+
+    for (int t = 0; t < context->pool->threadCount; t++)
+    {
+        addSearchStats(&search->stats, &split.searches[t].stats);
+        search->aborted |= split.searches[t].aborted;
+    }
+    // every thread started from the same history, what each of them learned is added up for the next depth.
+    // a thread that halved its scores gives back less than it started with, which is why the sum can't go below 0.
+    // the killers of one thread are as good as any other's
+    for (int side = 0; side < 2; side++)
+    {
+        for (int cell = 0; cell < size * size; cell++)
+        {
+            int merged = search->history[side][cell];
+            for (int t = 0; t < context->pool->threadCount; t++)
+                merged += split.searches[t].history[side][cell] - search->history[side][cell];
+            search->history[side][cell] = min(max(merged, 0), HISTORY_LIMIT);
+        }
+    }
+    memcpy(search->killers, split.searches[0].killers, sizeof(search->killers));
+    if (search->aborted)
+        return -1;
+
+    *bestValue = split.bestVal;
+    return split.bestIndex < split.moveCount ? split.moves[split.bestIndex] : -1;
+}
+
+static Pair cellToPair(int cell, int size)
+{
+    Pair pair;
+    pair.a = cell < 0 ? -1 : cell / size;
+    pair.b = cell < 0 ? -1 : cell % size;
+    return pair;
+}
+
+Pair findBestMoveTimed(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType currentPlayer, bool playerStartFirst, int budgetMs)
+{
+    long long startMicros = currentTimeMicros();
+    // the classic board is already solved, the table answers in constant time
+    if (isClassicBoard(config))
+    {
+        context->stats = (SearchStats){0};
+        Pair move = findTableMove(board, currentPlayer, playerStartFirst);
+        context->stats.timeMs = (currentTimeMicros() - startMicros) / 1000.0;
+        return move;
+    }
+
+    // a solved board needs no search at all, otherwise the first moves of larger boards cost the most to search
+    // and come up in every game, the book has them precomputed
+    Pair storedMove;
+    if (probeSolvedDatabase(context->database, board, config, &storedMove, NULL)
+        || probeOpeningBook(context->book, board, config, &storedMove, NULL))
+    {
+        context->stats = (SearchStats){0};
+        context->stats.timeMs = (currentTimeMicros() - startMicros) / 1000.0;
+        return storedMove;
+    }
+
+    long long start = currentTimeMillis();
+    BoardSearch searchState;
+    BoardSearch *search = &searchState;
+    initBoardSearch(context, search, board, config, playerStartFirst);
+    search->deadline = start + budgetMs;
+
+    // if not even depth 1 finishes, any legal move beats no move at all
+    int bestCell = -1;
+    for (int i = 0; i < config.size * config.size && bestCell < 0; i++)
+    {
+        if (isCandidate(search, search->order[i] / config.size, search->order[i] % config.size))
+            bestCell = search->order[i];
+    }
+
+    // every depth starts with the best move of the previous one, so a cut off iteration loses nothing
+    int maxDepth = search->movesLeft;
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        search->depthLimit = depth;
+        int value;
+        int cell = searchBoardRoot(search, bestCell, &value);
+        if (search->aborted || cell < 0)
+            break;
+        bestCell = cell;
+
+        // a forced win or loss won't change with more depth
+        if (abs(value) >= WIN_SCORE - maxDepth)
+            break;
+
+        // the next depth costs several times this one, don't start it if it can't finish
+        long long elapsed = currentTimeMillis() - start;
+        if (elapsed * 2 >= budgetMs)
+            break;
+    }
+    context->stats = search->stats;
+    context->stats.timeMs = (currentTimeMicros() - startMicros) / 1000.0;
+    return cellToPair(bestCell, config.size);
+}
+
+// root of the search on any board that isn't the classic 3x3, value is set to the score of the returned move
+static Pair findBoardMove(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, bool playerStartFirst, int *value)
+{
+    BoardSearch searchState;
+    BoardSearch *search = &searchState;
+    initBoardSearch(context, search, board, config, playerStartFirst);
+
+    int cell = searchBoardRoot(search, -1, value);
+    if (cell < 0)
+        *value = 0;
+    context->stats = search->stats;
+    return cellToPair(cell, config.size);
+}
+
+Pair findBestMove(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType currentPlayer, bool playerStartFirst)
+{
+    // a full depth search is perfect play, which is already solved in the table for 3x3.
+    // larger boards can't be searched to the end, so they get as deep as the time budget allows.
+    if (context->maxDepth >= CLASSIC_MAX_DEPTH)
+        return findBestMoveTimed(context, board, config, currentPlayer, playerStartFirst, DEFAULT_MOVE_BUDGET_MS);
+
+    long long start = currentTimeMicros();
+    Pair move;
+    if (!isClassicBoard(config))
+    {
+        int value;
+        move = findBoardMove(context, board, config, playerStartFirst, &value);
+    }
+    else
+    {
+        move = findClassicMove(context, board, currentPlayer, playerStartFirst);
+    }
+    context->stats.timeMs = (currentTimeMicros() - start) / 1000.0;
+    return move;
+}
+
+// true if someone already has winLength in a row or the board is full
+static bool isGameOver(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config)
+{
+    for (int i = 0; i < config.size; i++)
+    {
+        for (int j = 0; j < config.size; j++)
+        {
+            if (board[i][j] != BOARD_EMPTY && isWinningMove(board, config, i, j))
+                return true;
+        }
+    }
+    return !isMovesLeft(board, config);
+}
+
+Pair solvePosition(SearchContext *context, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int toMove, int *value)
+{
+    if (isGameOver(board, config))
+    {
+        context->stats = (SearchStats){0};
+        *value = 0;
+        return cellToPair(-1, config.size);
+    }
+
+    // the engine plays whoever didn't start, so pretend the player started when it is O's turn.
+    // the classic board goes through the generic search as well, its scores are exact for either side to move
+    // while the bitboard search keeps the old difficulty behaviour.
+    long long start = currentTimeMicros();
+    bool playerStartFirst = toMove == BOARD_NOUGHT;
+    Pair move = findBoardMove(context, board, config, playerStartFirst, value);
+    context->stats.timeMs = (currentTimeMicros() - start) / 1000.0;
+    return move;
+}
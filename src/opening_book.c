@@ -0,0 +1,130 @@
+#include <include/opening_book.h>
+#include <include/transposition.h>
+#include <string.h>
+
+int transformBookCell(int cell, int size, int symmetry)
+{
+    int row = cell / size;
+    int col = cell % size;
+    int last = size - 1;
+    int r, c;
+    // same order as SYMMETRY_CELLS: rotations 0, 90, 180, 270, then the 4 reflections
+    switch (symmetry)
+    {
+        case 1: r = col; c = last - row; break;
+        case 2: r = last - row; c = last - col; break;
+        case 3: r = last - col; c = row; break;
+        case 4: r = row; c = last - col; break;
+        case 5: r = last - row; c = col; break;
+        case 6: r = col; c = row; break;
+        case 7: r = last - col; c = last - row; break;
+        default: r = row; c = col; break;
+    }
+    return r * size + c;
+}
+
+uint64_t openingBookKey(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int *symmetry)
+{
+    int size = config.size;
+    uint64_t keys[SYMMETRY_COUNT] = {0};
+    for (int cell = 0; cell < size * size; cell++)
+    {
+        int piece = board[cell / size][cell % size];
+        if (piece == BOARD_EMPTY)
+            continue;
+        for (int s = 0; s < SYMMETRY_COUNT; s++)
+        {
+            int t = transformBookCell(cell, size, s);
+            keys[s] ^= zobristKey((t / size) * MAX_BOARD_SIZE + t % size, piece);
+        }
+    }
+
+    int best = 0;
+    for (int s = 1; s < SYMMETRY_COUNT; s++)
+    {
+        if (keys[s] < keys[best])
+            best = s;
+    }
+    *symmetry = best;
+    // the board goes in as a cell past the end of the board, so the same pieces on another board give another key
+    return keys[best] ^ zobristKey(MAX_BOARD_SIZE * MAX_BOARD_SIZE + 1 + config.size * MAX_BOARD_SIZE + config.winLength, BOARD_EMPTY);
+}
+
+OpeningBook *openOpeningBook(const char *path)
+{
+    MappedFile file;
+    if (!mapFile(path, &file))
+        return NULL;
+
+    const BookHeader *header = file.data;
+    bool valid = file.size >= sizeof(BookHeader)
+              && memcmp(header->magic, OPENING_BOOK_MAGIC, sizeof(OPENING_BOOK_MAGIC)) == 0
+              && header->version == OPENING_BOOK_VERSION
+              && header->entrySize == sizeof(BookEntry)
+              && header->entryCount <= (file.size - sizeof(BookHeader)) / sizeof(BookEntry);
+    if (!valid)
+    {
+        fprintf(stderr, "%s is not a valid opening book, ignoring it\n", path);
+        unmapFile(&file);
+        return NULL;
+    }
+
+    OpeningBook *book = malloc(sizeof(OpeningBook));
+    if (unlikely(book == NULL))
+    {
+        fprintf(stderr, "Memory allocation failed in openOpeningBook! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    book->entries = (const BookEntry *)((const char *)file.data + sizeof(BookHeader));
+    book->entryCount = (size_t)header->entryCount;
+    book->file = file;
+    return book;
+}
+
+void closeOpeningBook(OpeningBook *book)
+{
+    if (book == NULL)
+        return;
+    unmapFile(&book->file);
+    free(book);
+}
+
+bool probeOpeningBook(const OpeningBook *book, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, Pair *move, int *value)
+{
+    if (book == NULL || book->entryCount == 0)
+        return false;
+
+    int symmetry;
+    uint64_t key = openingBookKey(board, config, &symmetry);
+
+    // binary search, so a probe only touches log2(entryCount) entries and the pages they sit on
+    size_t low = 0;
+    size_t high = book->entryCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (book->entries[middle].key < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == book->entryCount || book->entries[low].key != key)
+        return false;
+
+    const BookEntry *entry = &book->entries[low];
+    int size = config.size;
+    if (entry->size != size || entry->winLength != config.winLength || entry->cell >= size * size)
+        return false;
+
+    // the entry is in the canonical orientation, turn its move back onto this board
+    int cell = transformBookCell(entry->cell, size, INVERSE_SYMMETRY[symmetry]);
+    // a key collision could point at a taken cell, searching is better than an illegal move
+    if (board[cell / size][cell % size] != BOARD_EMPTY)
+        return false;
+
+    move->a = cell / size;
+    move->b = cell % size;
+    if (value != NULL)
+        *value = entry->value;
+    return true;
+}
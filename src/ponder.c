@@ -0,0 +1,201 @@
+#include <include/ponder.h>
+#include <include/game.h>
+#include <string.h>
+
+Ponder *createPonder(SearchContext *context)
+{
+    Ponder *ponder = malloc(sizeof(Ponder));
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if (unlikely(ponder == NULL))
+    {
+        fprintf(stderr, "Memory allocation failed in createPonder! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    ponder->context = context;
+    ponder->running = false;
+    ponder->answerCount = 0;
+    return ponder;
+}
+
+void destroyPonder(Ponder *ponder)
+{
+    if (ponder == NULL)
+        return;
+    stopPondering(ponder);
+    free(ponder);
+}
+
+static inline bool isPonderCancelled(Ponder *ponder)
+{
+    return atomic_load_explicit(&ponder->context->cancelled, memory_order_relaxed);
+}
+
+// fills cells with the replies worth pondering, the predicted one first and then the nearest to a piece,
+// center-out among equals. returns the number of replies.
+static int orderReplies(Ponder *ponder, int predicted, int cells[MAX_BOARD_SIZE * MAX_BOARD_SIZE])
+{
+    int size = ponder->config.size;
+    bool restrictToNeighbours = size > FULL_WIDTH_MAX_SIZE;
+    int distances[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    int count = 0;
+    for (int cell = 0; cell < size * size; cell++)
+    {
+        int row = cell / size;
+        int col = cell % size;
+        if (ponder->board[row][col] != BOARD_EMPTY || cell == predicted)
+            continue;
+
+        // distance to the nearest piece, the empty board has none so everything ties
+        int nearest = size;
+        for (int other = 0; other < size * size; other++)
+        {
+            if (ponder->board[other / size][other % size] != BOARD_EMPTY)
+                nearest = min(nearest, max(abs(other / size - row), abs(other % size - col)));
+        }
+        if (restrictToNeighbours && nearest > NEIGHBOUR_RADIUS && nearest != size)
+            continue;
+        int fromCenter = max(abs(2 * row - (size - 1)), abs(2 * col - (size - 1)));
+        distances[count] = nearest * 2 * size + fromCenter;
+        cells[count++] = cell;
+    }
+
+    // insertion sort, a few hundred cells at most and it keeps equal cells in board order
+    for (int i = 1; i < count; i++)
+    {
+        int cell = cells[i];
+        int distance = distances[i];
+        int j = i - 1;
+        while (j >= 0 && distances[j] > distance)
+        {
+            cells[j + 1] = cells[j];
+            distances[j + 1] = distances[j];
+            j--;
+        }
+        cells[j + 1] = cell;
+        distances[j + 1] = distance;
+    }
+
+    if (predicted >= 0)
+    {
+        memmove(cells + 1, cells, count * sizeof(int));
+        cells[0] = predicted;
+        count++;
+    }
+    return count;
+}
+
+static void *ponderThread(void *arg)
+{
+    Ponder *ponder = arg;
+    SearchContext *context = ponder->context;
+    BoardConfig config = ponder->config;
+    int size = config.size;
+    int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+
+    // guess the human's reply with a short search from their side
+    int maxDepth = context->maxDepth;
+    context->maxDepth = PONDER_PREDICTION_DEPTH;
+    memcpy(board, ponder->board, sizeof(board));
+    int value;
+    Pair prediction = solvePosition(context, board, config, ponder->humanPiece, &value);
+    context->maxDepth = maxDepth;
+
+    int replies[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    int replyCount = orderReplies(ponder, prediction.a < 0 || isPonderCancelled(ponder) ? -1 : prediction.a * size + prediction.b, replies);
+
+    for (int i = 0; i < replyCount && !isPonderCancelled(ponder); i++)
+    {
+        int row = replies[i] / size;
+        int col = replies[i] % size;
+        memcpy(board, ponder->board, sizeof(board));
+        board[row][col] = ponder->humanPiece;
+        // the game is over after this reply, there is nothing for the AI to answer
+        if (isWinningMove(board, config, row, col) || !isMovesLeft(board, config))
+            continue;
+
+        Pair answer = findBestMoveTimed(context, board, config, ponder->aiPlayer, ponder->playerStartFirst, DEFAULT_MOVE_BUDGET_MS);
+        // a cancelled search stopped early, its move isn't what the AI would play
+        if (isPonderCancelled(ponder))
+            break;
+        ponder->replies[ponder->answerCount] = replies[i];
+        ponder->answers[ponder->answerCount] = answer;
+        ponder->answerStats[ponder->answerCount] = context->stats;
+        ponder->answerCount++;
+    }
+    return NULL;
+}
+
+void startPondering(Ponder *ponder, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, PlayerType aiPlayer, bool playerStartFirst)
+{
+    stopPondering(ponder);
+    memcpy(ponder->board, board, sizeof(ponder->board));
+    ponder->config = config;
+    ponder->aiPlayer = aiPlayer;
+    ponder->playerStartFirst = playerStartFirst;
+
+    int crosses = 0;
+    int noughts = 0;
+    for (int i = 0; i < config.size; i++)
+    {
+        for (int j = 0; j < config.size; j++)
+        {
+            crosses += board[i][j] == BOARD_CROSS;
+            noughts += board[i][j] == BOARD_NOUGHT;
+        }
+    }
+    ponder->humanPiece = crosses == noughts ? BOARD_CROSS : BOARD_NOUGHT;
+
+    // pondering is only a head start, if the thread can't be created the AI just searches on its turn
+    ponder->running = pthread_create(&ponder->thread, NULL, ponderThread, ponder) == 0;
+}
+
+// cancels and joins the thread, the answers it found stay
+static void joinPonderThread(Ponder *ponder)
+{
+    if (!ponder->running)
+        return;
+    cancelSearch(ponder->context);
+    pthread_join(ponder->thread, NULL);
+    resetSearchCancel(ponder->context);
+    ponder->running = false;
+}
+
+void stopPondering(Ponder *ponder)
+{
+    joinPonderThread(ponder);
+    ponder->answerCount = 0;
+}
+
+bool ponderHit(Ponder *ponder, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Pair *move)
+{
+    joinPonderThread(ponder);
+    int answerCount = ponder->answerCount;
+    ponder->answerCount = 0;
+    if (answerCount == 0)
+        return false;
+
+    // the board must be the pondered position plus exactly one human piece
+    int size = ponder->config.size;
+    int reply = -1;
+    for (int cell = 0; cell < size * size; cell++)
+    {
+        int before = ponder->board[cell / size][cell % size];
+        int after = board[cell / size][cell % size];
+        if (before == after)
+            continue;
+        if (reply >= 0 || before != BOARD_EMPTY || after != ponder->humanPiece)
+            return false;
+        reply = cell;
+    }
+
+    for (int i = 0; i < answerCount; i++)
+    {
+        if (ponder->replies[i] == reply)
+        {
+            *move = ponder->answers[i];
+            ponder->context->stats = ponder->answerStats[i];
+            return true;
+        }
+    }
+    return false;
+}
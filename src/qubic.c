@@ -0,0 +1,112 @@
+#include <include/qubic.h>
+#include <include/game.h>
+#include <string.h>
+
+void initQubicBoard(QubicBoard *board)
+{
+    memset(board, 0, sizeof(QubicBoard));
+    board->toMove = BOARD_CROSS;
+    board->winner = BOARD_EMPTY;
+}
+
+void playQubicMove(QubicBoard *board, int cell)
+{
+    uint64_t bit = 1ull << cell;
+    uint64_t mine;
+    if (board->toMove == BOARD_CROSS)
+        mine = board->cross |= bit;
+    else
+        mine = board->nought |= bit;
+    board->movesMade++;
+
+    // only a line through the new piece can have been completed
+    for (int i = 0; i < QUBIC_CELL_LINE_COUNT[cell]; i++)
+    {
+        uint64_t line = QUBIC_LINES[QUBIC_CELL_LINES[cell][i]];
+        if ((mine & line) == line)
+        {
+            board->winner = board->toMove;
+            break;
+        }
+    }
+    if (board->winner == BOARD_EMPTY && board->movesMade == QUBIC_CELLS)
+        board->winner = QUBIC_DRAW;
+    board->toMove = board->toMove == BOARD_CROSS ? BOARD_NOUGHT : BOARD_CROSS;
+}
+
+uint64_t qubicThreats(uint64_t mine, uint64_t theirs)
+{
+    uint64_t threats = 0;
+    for (int i = 0; i < QUBIC_LINE_COUNT; i++)
+    {
+        uint64_t line = QUBIC_LINES[i];
+        if (countCells(mine & line) == 3 && (theirs & line) == 0)
+            threats |= line & ~mine;
+    }
+    return threats;
+}
+
+void newQubicGame(QubicGame *game)
+{
+    initQubicBoard(&game->positions[0]);
+    game->current = 0;
+    game->last = 0;
+}
+
+bool playQubicGameMove(QubicGame *game, int cell)
+{
+    if (cell < 0 || cell >= QUBIC_CELLS || (qubicEmptyCells(qubicGameBoard(game)) & (1ull << cell)) == 0)
+        return false;
+    game->positions[game->current + 1] = game->positions[game->current];
+    playQubicMove(&game->positions[game->current + 1], cell);
+    game->current++;
+    game->last = game->current;
+    return true;
+}
+
+void syncQubicGameState(GameState *state, const QubicBoard *board)
+{
+    PlayerType crossPlayer = state->player1StartFirst ? state->player : state->opponent;
+    PlayerType noughtPlayer = state->player1StartFirst ? state->opponent : state->player;
+    state->turn = board->toMove == BOARD_CROSS ? crossPlayer : noughtPlayer;
+    state->isDraw = board->winner == QUBIC_DRAW;
+    if (board->winner == BOARD_CROSS)
+        state->winner = crossPlayer;
+    else if (board->winner == BOARD_NOUGHT)
+        state->winner = noughtPlayer;
+    else
+        state->winner = UNASSIGNED;
+
+    for (int cell = 0; cell < QUBIC_CELLS; cell++)
+    {
+        uint64_t bit = 1ull << cell;
+        int piece = (board->cross & bit) ? BOARD_CROSS : (board->nought & bit) ? BOARD_NOUGHT : BOARD_EMPTY;
+        state->board[qubicMoveRow(cell)][qubicMoveCol(cell)] = piece;
+    }
+    state->movesMade = board->movesMade;
+}
+
+void undoQubicTurn(GameState *state, QubicGame *game)
+{
+    bool againstAi = state->opponent == AI;
+    // when the AI started, its first move stays on the board like in undo
+    int firstMove = againstAi && !state->player1StartFirst ? 1 : 0;
+    if (game->current <= firstMove)
+        return;
+    do
+    {
+        game->current--;
+        syncQubicGameState(state, qubicGameBoard(game));
+    } while (againstAi && state->turn == state->opponent && game->current > firstMove);
+}
+
+void redoQubicTurn(GameState *state, QubicGame *game)
+{
+    if (game->current == game->last)
+        return;
+    do
+    {
+        game->current++;
+        syncQubicGameState(state, qubicGameBoard(game));
+    } while (state->opponent == AI && state->turn == state->opponent && game->current < game->last);
+}
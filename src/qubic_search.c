@@ -0,0 +1,347 @@
+#include <include/qubic_search.h>
+#include <pthread.h>
+#include <string.h>
+
+// value of a line holding 0 to 3 pieces of one side and none of the other's
+static const int LINE_WEIGHTS[4] = {0, 1, 6, 40};
+
+// how often the search looks at the clock, in nodes
+#define CLOCK_CHECK_INTERVAL 1024
+
+/// @brief State of one search thread, the board itself is copied down the tree.
+typedef struct QubicSearch{
+    SearchContext *context;
+    SearchStats stats;
+    long long deadline; // currentTimeMillis when the search has to stop, 0 for none
+    bool aborted; // set once the deadline has passed or the search was cancelled, every node returns straight away after that
+}QubicSearch;
+
+/// @brief Root moves handed out to the search threads, see searchRootMoves in minimax.c.
+typedef struct QubicRootSplit{
+    QubicSearch *searches; // one per thread
+    const QubicBoard *board;
+    uint64_t hash;
+    int depth;
+    uint8_t moves[QUBIC_CELLS];
+    int moveCount;
+    atomic_int nextMove; // index of the next move nobody has taken yet
+    pthread_mutex_t lock; // guards bestVal and bestIndex
+    int bestVal;
+    int bestIndex; // index into moves, moveCount while nothing has been searched
+}QubicRootSplit;
+
+int evaluateQubicBoard(const QubicBoard *board)
+{
+    uint64_t mine = board->toMove == BOARD_CROSS ? board->cross : board->nought;
+    uint64_t theirs = board->toMove == BOARD_CROSS ? board->nought : board->cross;
+    int score = 0;
+    for (int i = 0; i < QUBIC_LINE_COUNT; i++)
+    {
+        uint64_t line = QUBIC_LINES[i];
+        int mineCount = countCells(mine & line);
+        int theirCount = countCells(theirs & line);
+        if (theirCount == 0)
+            score += LINE_WEIGHTS[mineCount];
+        else if (mineCount == 0)
+            score -= LINE_WEIGHTS[theirCount];
+    }
+    return score;
+}
+
+static inline bool isAborted(QubicSearch *search)
+{
+    if (!search->aborted && (search->stats.nodes % CLOCK_CHECK_INTERVAL) == 0)
+    {
+        if (atomic_load_explicit(&search->context->cancelled, memory_order_relaxed)
+            || (search->deadline != 0 && currentTimeMillis() >= search->deadline))
+            search->aborted = true;
+    }
+    return search->aborted;
+}
+
+// win scores depend on the distance from the root, the table stores them relative to the position instead
+static inline int scoreToTable(int value, int ply)
+{
+    if (value > QUBIC_WIN_SCORE / 2)
+        return value + ply;
+    if (value < -QUBIC_WIN_SCORE / 2)
+        return value - ply;
+    return value;
+}
+
+static inline int scoreFromTable(int value, int ply)
+{
+    if (value > QUBIC_WIN_SCORE / 2)
+        return value - ply;
+    if (value < -QUBIC_WIN_SCORE / 2)
+        return value + ply;
+    return value;
+}
+
+// writes the cells of candidates to moves, best first: first, then the cells on the most lines that are still
+// open for either side, weighted like the evaluation
+static int orderMoves(const QubicBoard *board, uint64_t candidates, int first, uint8_t moves[QUBIC_CELLS])
+{
+    uint64_t mine = board->toMove == BOARD_CROSS ? board->cross : board->nought;
+    uint64_t theirs = board->toMove == BOARD_CROSS ? board->nought : board->cross;
+    int scores[QUBIC_CELLS];
+    int count = 0;
+    for (; candidates != 0; candidates &= candidates - 1)
+    {
+        int cell = lowestQubicCell(candidates);
+        int score = 0;
+        for (int i = 0; i < QUBIC_CELL_LINE_COUNT[cell]; i++)
+        {
+            uint64_t line = QUBIC_LINES[QUBIC_CELL_LINES[cell][i]];
+            int mineCount = countCells(mine & line);
+            int theirCount = countCells(theirs & line);
+            // building on our own line counts a little more than blocking theirs
+            if (theirCount == 0)
+                score += LINE_WEIGHTS[mineCount] * 2 + 1;
+            else if (mineCount == 0)
+                score += LINE_WEIGHTS[theirCount] * 2;
+        }
+        if (cell == first)
+            score = 1 << 20;
+
+        // insertion sort, at most 64 moves
+        int j = count - 1;
+        while (j >= 0 && scores[j] < score)
+        {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        moves[j + 1] = (uint8_t)cell;
+        scores[j + 1] = score;
+        count++;
+    }
+    return count;
+}
+
+// negamax with alpha-beta, value for the side to move of board. hash is the Zobrist key of the position.
+static int negamax(QubicSearch *search, const QubicBoard *board, uint64_t hash, int depth, int ply, int alpha, int beta)
+{
+    search->stats.nodes++;
+    if (ply + 1 > search->stats.maxDepth)
+        search->stats.maxDepth = ply + 1;
+
+    // the side that just moved ended the game
+    if (board->winner != BOARD_EMPTY)
+        return board->winner == QUBIC_DRAW ? 0 : -(QUBIC_WIN_SCORE - ply);
+    if (isAborted(search))
+        return 0;
+
+    uint64_t mine = board->toMove == BOARD_CROSS ? board->cross : board->nought;
+    uint64_t theirs = board->toMove == BOARD_CROSS ? board->nought : board->cross;
+    // a line we can complete wins right now, two the opponent can complete can't both be blocked
+    if (qubicThreats(mine, theirs) != 0)
+        return QUBIC_WIN_SCORE - ply - 1;
+    uint64_t threats = qubicThreats(theirs, mine);
+    if (countCells(threats) >= 2)
+        return -(QUBIC_WIN_SCORE - ply - 2);
+    // a single threat leaves one sensible move, which is played without using up depth so forcing
+    // sequences are seen to the end
+    bool forced = threats != 0;
+    if (depth <= 0 && !forced)
+        return evaluateQubicBoard(board);
+
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int hashCell = -1;
+    SharedTTEntry entry;
+    if (probeSharedTable(search->context->sharedTable, hash, &entry))
+    {
+        search->stats.hashHits++;
+        if (entry.depth >= depth)
+        {
+            int value = scoreFromTable(entry.value, ply);
+            if (entry.bound == BOUND_EXACT)
+                return value;
+            if (entry.bound == BOUND_LOWER)
+                alpha = max(alpha, value);
+            else
+                beta = min(beta, value);
+            if (alpha >= beta)
+            {
+                search->stats.cutoffs++;
+                return value;
+            }
+        }
+        hashCell = entry.bestCell;
+    }
+
+    uint8_t moves[QUBIC_CELLS];
+    int count = orderMoves(board, forced ? threats : qubicEmptyCells(board), hashCell, moves);
+    int childDepth = forced ? depth : depth - 1;
+    int piece = board->toMove;
+    int best = -QUBIC_WIN_SCORE - 1;
+    int bestCell = -1;
+    for (int i = 0; i < count; i++)
+    {
+        QubicBoard child = *board;
+        playQubicMove(&child, moves[i]);
+        int value = -negamax(search, &child, hash ^ zobristKey(moves[i], piece), childDepth, ply + 1, -beta, -alpha);
+        if (search->aborted)
+            return 0;
+        if (value > best)
+        {
+            best = value;
+            bestCell = moves[i];
+        }
+        if (best > alpha)
+            alpha = best;
+        if (alpha >= beta)
+        {
+            search->stats.cutoffs++;
+            break;
+        }
+    }
+
+    BoundType bound = BOUND_EXACT;
+    if (best <= alphaOrig)
+        bound = BOUND_UPPER;
+    else if (best >= betaOrig)
+        bound = BOUND_LOWER;
+    storeSharedTable(search->context->sharedTable, hash, scoreToTable(best, ply), bound, max(depth, 0), bestCell);
+    return best;
+}
+
+// run by every thread of the pool, like searchRootMoves in minimax.c: each thread takes the next root move nobody
+// has taken and searches it with the best score any thread has found so far as alpha, ties go to the earlier move
+static void searchQubicRootMoves(void *arg, int threadIndex)
+{
+    QubicRootSplit *split = arg;
+    QubicSearch *search = &split->searches[threadIndex];
+    int piece = split->board->toMove;
+    while (!search->aborted)
+    {
+        int i = atomic_fetch_add(&split->nextMove, 1);
+        if (i >= split->moveCount)
+            break;
+
+        pthread_mutex_lock(&split->lock);
+        int alpha = i < split->bestIndex ? split->bestVal - 1 : split->bestVal;
+        pthread_mutex_unlock(&split->lock);
+
+        QubicBoard child = *split->board;
+        playQubicMove(&child, split->moves[i]);
+        int value = -negamax(search, &child, split->hash ^ zobristKey(split->moves[i], piece), split->depth - 1, 1,
+                             -QUBIC_WIN_SCORE - 1, -alpha);
+        if (search->aborted)
+            break;
+
+        pthread_mutex_lock(&split->lock);
+        if (value > split->bestVal || (value == split->bestVal && i < split->bestIndex))
+        {
+            split->bestVal = value;
+            split->bestIndex = i;
+        }
+        pthread_mutex_unlock(&split->lock);
+    }
+}
+
+Pair findBestQubicMove(SearchContext *context, const QubicBoard *board, int budgetMs)
+{
+    long long startMicros = currentTimeMicros();
+    long long start = currentTimeMillis();
+    context->stats = (SearchStats){0};
+    Pair pair = {-1, -1};
+    uint64_t empty = qubicEmptyCells(board);
+    if (empty == 0)
+    {
+        context->stats.timeMs = (currentTimeMicros() - startMicros) / 1000.0;
+        return pair;
+    }
+
+    // scores are relative to this root, so nothing carries over from the last move
+    if (context->sharedTable == NULL)
+        context->sharedTable = createSharedTranspositionTable(SHARED_TRANSPOSITION_TABLE_SIZE);
+    newSharedSearchGeneration(context->sharedTable);
+
+    uint64_t mine = board->toMove == BOARD_CROSS ? board->cross : board->nought;
+    uint64_t theirs = board->toMove == BOARD_CROSS ? board->nought : board->cross;
+    uint64_t wins = qubicThreats(mine, theirs);
+    uint64_t threats = qubicThreats(theirs, mine);
+    int bestCell;
+    if (wins != 0 || threats != 0)
+    {
+        // win straight away, or block; against two threats blocking one is as good as anything
+        bestCell = lowestQubicCell(wins != 0 ? wins : threats);
+    }
+    else
+    {
+        ThreadPool *pool = searchThreadPool(context);
+        QubicSearch *searches = malloc(sizeof(QubicSearch) * pool->threadCount);
+        // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+        if (unlikely(searches == NULL))
+        {
+            fprintf(stderr, "Memory allocation failed in findBestQubicMove! This might be an Operating System Issue! Terminating.\n");
+            exit(1);
+        }
+
+        QubicRootSplit split;
+        split.searches = searches;
+        split.board = board;
+        split.hash = 0;
+        for (int cell = 0; cell < QUBIC_CELLS; cell++)
+        {
+            if (board->cross & (1ull << cell))
+                split.hash ^= zobristKey(cell, BOARD_CROSS);
+            else if (board->nought & (1ull << cell))
+                split.hash ^= zobristKey(cell, BOARD_NOUGHT);
+        }
+        pthread_mutex_init(&split.lock, NULL);
+
+        // if not even depth 1 finishes, any legal move beats no move at all
+        bestCell = orderMoves(board, empty, -1, split.moves) > 0 ? split.moves[0] : -1;
+        bool timed = context->maxDepth >= CLASSIC_MAX_DEPTH;
+        int maxDepth = timed ? QUBIC_CELLS - board->movesMade : context->maxDepth;
+        long long deadline = timed ? start + budgetMs : 0;
+        bool aborted = false;
+        for (int depth = 1; depth <= maxDepth && !aborted; depth++)
+        {
+            // every depth starts with the best move of the previous one
+            split.moveCount = orderMoves(board, empty, bestCell, split.moves);
+            split.depth = depth;
+            atomic_store(&split.nextMove, 0);
+            split.bestVal = -QUBIC_WIN_SCORE - 1;
+            split.bestIndex = split.moveCount;
+            for (int t = 0; t < pool->threadCount; t++)
+            {
+                searches[t].context = context;
+                searches[t].stats = (SearchStats){0};
+                searches[t].deadline = deadline;
+                searches[t].aborted = false;
+            }
+            runThreadPool(pool, searchQubicRootMoves, &split);
+
+            for (int t = 0; t < pool->threadCount; t++)
+            {
+                addSearchStats(&context->stats, &searches[t].stats);
+                aborted |= searches[t].aborted;
+            }
+            if (aborted || split.bestIndex == split.moveCount)
+                break;
+            bestCell = split.moves[split.bestIndex];
+
+            // a forced win or loss won't change with more depth
+            if (abs(split.bestVal) >= QUBIC_WIN_SCORE - QUBIC_CELLS)
+                break;
+
+            // the next depth costs several times this one, don't start it if it can't finish
+            if (timed && (currentTimeMillis() - start) * 2 >= budgetMs)
+                break;
+        }
+        pthread_mutex_destroy(&split.lock);
+        free(searches);
+    }
+
+    context->stats.timeMs = (currentTimeMicros() - startMicros) / 1000.0;
+    if (bestCell >= 0)
+    {
+        pair.a = qubicMoveRow(bestCell);
+        pair.b = qubicMoveCol(bestCell);
+    }
+    return pair;
+}
@@ -0,0 +1,171 @@
+#include <include/solved_database.h>
+#include <include/game.h>
+#include <string.h>
+
+void solvedDatabasePath(BoardConfig config, char *buffer, size_t size)
+{
+    snprintf(buffer, size, "solved_%dx%d_%d.bin", config.size, config.size, config.winLength);
+}
+
+uint64_t solvedPositionIndex(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config)
+{
+    uint64_t index = 0;
+    // Horner's rule from the last cell down, so cell i ends up multiplied by 3^i
+    for (int cell = config.size * config.size - 1; cell >= 0; cell--)
+        index = index * 3 + board[cell / config.size][cell % config.size];
+    return index;
+}
+
+SolvedDatabase *openSolvedDatabase(const char *path)
+{
+    MappedFile file;
+    if (!mapFile(path, &file))
+        return NULL;
+
+    const SolvedHeader *header = file.data;
+    bool valid = file.size >= sizeof(SolvedHeader)
+              && memcmp(header->magic, SOLVED_DATABASE_MAGIC, sizeof(SOLVED_DATABASE_MAGIC)) == 0
+              && header->version == SOLVED_DATABASE_VERSION
+              && header->size >= 1 && header->size * header->size <= SOLVED_DATABASE_MAX_CELLS
+              && header->winLength >= 1 && header->winLength <= header->size;
+    if (valid)
+    {
+        uint64_t positionCount = 1;
+        for (int i = 0; i < header->size * header->size; i++)
+            positionCount *= 3;
+        valid = header->positionCount == positionCount
+             && (file.size - sizeof(SolvedHeader)) >= (positionCount + 3) / 4;
+    }
+    if (!valid)
+    {
+        fprintf(stderr, "%s is not a valid solved database, ignoring it\n", path);
+        unmapFile(&file);
+        return NULL;
+    }
+
+    SolvedDatabase *database = malloc(sizeof(SolvedDatabase));
+    if (unlikely(database == NULL))
+    {
+        fprintf(stderr, "Memory allocation failed in openSolvedDatabase! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    database->config.size = header->size;
+    database->config.winLength = header->winLength;
+    database->results = (const uint8_t *)file.data + sizeof(SolvedHeader);
+    database->positionCount = header->positionCount;
+    database->file = file;
+    return database;
+}
+
+SolvedDatabase *openPresetDatabase()
+{
+    for (int i = 0; i < BOARD_PRESET_COUNT; i++)
+    {
+        BoardConfig config = BOARD_PRESETS[i];
+        if (isClassicBoard(config) || config.size * config.size > SOLVED_DATABASE_MAX_CELLS)
+            continue;
+        char path[64];
+        solvedDatabasePath(config, path, sizeof(path));
+        SolvedDatabase *database = openSolvedDatabase(path);
+        if (database != NULL)
+            return database;
+    }
+    return NULL;
+}
+
+void closeSolvedDatabase(SolvedDatabase *database)
+{
+    if (database == NULL)
+        return;
+    unmapFile(&database->file);
+    free(database);
+}
+
+// true if side has a move that wins straight away
+static bool canWinNext(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int side)
+{
+    for (int row = 0; row < config.size; row++)
+    {
+        for (int col = 0; col < config.size; col++)
+        {
+            if (board[row][col] != BOARD_EMPTY)
+                continue;
+            board[row][col] = side;
+            bool wins = isWinningMove(board, config, row, col);
+            board[row][col] = BOARD_EMPTY;
+            if (wins)
+                return true;
+        }
+    }
+    return false;
+}
+
+bool probeSolvedDatabase(const SolvedDatabase *database, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, Pair *move, int *value)
+{
+    if (database == NULL || database->config.size != config.size || database->config.winLength != config.winLength)
+        return false;
+
+    int size = config.size;
+    int crosses = 0;
+    int noughts = 0;
+    uint64_t powers[SOLVED_DATABASE_MAX_CELLS];
+    uint64_t power = 1;
+    for (int cell = 0; cell < size * size; cell++)
+    {
+        int piece = board[cell / size][cell % size];
+        crosses += piece == BOARD_CROSS;
+        noughts += piece == BOARD_NOUGHT;
+        powers[cell] = power;
+        power *= 3;
+    }
+    if (crosses != noughts && crosses != noughts + 1)
+        return false;
+    int toMove = crosses == noughts ? BOARD_CROSS : BOARD_NOUGHT;
+    int opponent = toMove == BOARD_CROSS ? BOARD_NOUGHT : BOARD_CROSS;
+    uint64_t index = solvedPositionIndex(board, config);
+
+    // center-out, so equally good moves go to the cells on the most lines like everywhere else
+    int bestCell = -1;
+    int bestScore = 0;
+    int bestResult = 0;
+    for (int distance = 0; distance < size; distance++)
+    {
+        for (int cell = 0; cell < size * size; cell++)
+        {
+            int row = cell / size;
+            int col = cell % size;
+            if (board[row][col] != BOARD_EMPTY || max(abs(2 * row - (size - 1)), abs(2 * col - (size - 1))) != distance)
+                continue;
+
+            // the reply's result is for the opponent, a position they lose is one we win
+            int reply = solvedResult(database->results, index + powers[cell] * toMove);
+            if (unlikely(reply == SOLVED_UNKNOWN))
+                return false;
+            int result = reply == SOLVED_LOSS ? 1 : reply == SOLVED_DRAW ? 0 : -1;
+
+            // the tie breaks stay below the gap between two results
+            int score = result * 4;
+            board[row][col] = toMove;
+            if (isWinningMove(board, config, row, col))
+                score += 2;
+            else if (result < 0 && !canWinNext(board, config, opponent))
+                score += 1;
+            board[row][col] = BOARD_EMPTY;
+
+            if (bestCell < 0 || score > bestScore)
+            {
+                bestCell = cell;
+                bestScore = score;
+                bestResult = result;
+            }
+        }
+    }
+    if (bestCell < 0)
+        return false;
+
+    move->a = bestCell / size;
+    move->b = bestCell % size;
+    if (value != NULL)
+        *value = bestResult;
+    return true;
+}
@@ -0,0 +1,110 @@
+#include <include/thread_pool.h>
+
+typedef struct WorkerArgs{
+    ThreadPool *pool;
+    int threadIndex;
+}WorkerArgs;
+
+static void *workerMain(void *data){
+    WorkerArgs args = *(WorkerArgs *)data;
+    free(data);
+    ThreadPool *pool = args.pool;
+    unsigned long seenGeneration = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while(true){
+        while(!pool->shutdown && pool->generation == seenGeneration)
+            pthread_cond_wait(&pool->taskReady, &pool->lock);
+        if(pool->shutdown)
+            break;
+        seenGeneration = pool->generation;
+        ThreadPoolTask task = pool->task;
+        void *arg = pool->arg;
+        pthread_mutex_unlock(&pool->lock);
+
+        task(arg, args.threadIndex);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->running--;
+        if(pool->running == 0)
+            pthread_cond_signal(&pool->taskDone);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool *createThreadPool(int threadCount){
+    if(threadCount < 1)
+        threadCount = 1;
+
+    ThreadPool *pool = malloc(sizeof(ThreadPool));
+    pthread_t *workers = malloc(sizeof(pthread_t) * threadCount);
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if(unlikely(pool == NULL || workers == NULL)){
+        fprintf(stderr, "Memory allocation failed in createThreadPool! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+
+    pool->threadCount = threadCount;
+    pool->workers = workers;
+    pool->task = NULL;
+    pool->arg = NULL;
+    pool->generation = 0;
+    pool->running = 0;
+    pool->shutdown = false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->taskReady, NULL);
+    pthread_cond_init(&pool->taskDone, NULL);
+
+    // thread 0 is whoever calls runThreadPool, so only the others need a thread of their own
+    for(int i = 1; i < threadCount; i++){
+        WorkerArgs *args = malloc(sizeof(WorkerArgs));
+        if(unlikely(args == NULL)){
+            fprintf(stderr, "Memory allocation failed in createThreadPool! This might be an Operating System Issue! Terminating.\n");
+            exit(1);
+        }
+        args->pool = pool;
+        args->threadIndex = i;
+        if(pthread_create(&workers[i], NULL, workerMain, args) != 0){
+            fprintf(stderr, "Unable to start search thread %d! Terminating.\n", i);
+            exit(1);
+        }
+    }
+    return pool;
+}
+
+void runThreadPool(ThreadPool *pool, ThreadPoolTask task, void *arg){
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->arg = arg;
+    pool->running = pool->threadCount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->taskReady);
+    pthread_mutex_unlock(&pool->lock);
+
+    task(arg, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while(pool->running > 0)
+        pthread_cond_wait(&pool->taskDone, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void destroyThreadPool(ThreadPool *pool){
+    if(pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->taskReady);
+    pthread_mutex_unlock(&pool->lock);
+
+    for(int i = 1; i < pool->threadCount; i++)
+        pthread_join(pool->workers[i], NULL);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->taskReady);
+    pthread_cond_destroy(&pool->taskDone);
+    free(pool->workers);
+    free(pool);
+}
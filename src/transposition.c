@@ -0,0 +1,149 @@
+#include <include/transposition.h>
+
+TranspositionTable *createTranspositionTable(size_t size){
+    size_t actualSize = 1;
+    while(actualSize < size)
+        actualSize <<= 1;
+
+    TranspositionTable *table = malloc(sizeof(TranspositionTable));
+    TTEntry *entries = calloc(actualSize, sizeof(TTEntry));
+
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if (unlikely(table == NULL || entries == NULL)) {
+        fprintf(stderr, "Memory allocation failed in createTranspositionTable! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+
+    table->entries = entries;
+    table->size = actualSize;
+    // calloc leaves every entry at generation 0, start at 1 so they all read as empty
+    table->generation = 1;
+    table->probes = 0;
+    table->hits = 0;
+    return table;
+}
+
+void destroyTranspositionTable(TranspositionTable *table){
+    if(table == NULL)
+        return;
+    free(table->entries);
+    free(table);
+}
+
+void newSearchGeneration(TranspositionTable *table){
+    table->generation++;
+    // generation 0 is reserved for never written entries, skip it on wrap around
+    if(unlikely(table->generation == 0)){
+        for(size_t i = 0; i < table->size; i++)
+            table->entries[i].generation = 0;
+        table->generation = 1;
+    }
+    table->probes = 0;
+    table->hits = 0;
+}
+
+// multiplicative hashing spreads the 18-bit keys over the whole table
+static inline size_t slotOf(TranspositionTable *table, uint32_t key){
+    return (size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ull) >> 32) & (table->size - 1);
+}
+
+bool probeTranspositionTable(TranspositionTable *table, uint32_t key, TTEntry *entry){
+    table->probes++;
+    TTEntry *slot = &table->entries[slotOf(table, key)];
+    if(slot->generation != table->generation || slot->key != key)
+        return false;
+    table->hits++;
+    *entry = *slot;
+    return true;
+}
+
+void storeTranspositionTable(TranspositionTable *table, uint32_t key, int value, BoundType bound, int bestCell){
+    TTEntry *slot = &table->entries[slotOf(table, key)];
+    slot->key = key;
+    slot->value = (int8_t)value;
+    slot->bound = (uint8_t)bound;
+    slot->bestCell = (int8_t)bestCell;
+    slot->generation = table->generation;
+}
+
+// layout of SharedTTSlot.data: value in bits 0-15, bound 16-17, depth 24-31, best cell 32-39 (255 for none), generation 40-47
+static inline uint64_t packSharedEntry(int value, BoundType bound, int depth, int bestCell, uint8_t generation){
+    return (uint64_t)(uint16_t)(int16_t)value
+        | (uint64_t)bound << 16
+        | (uint64_t)(uint8_t)depth << 24
+        | (uint64_t)(uint8_t)(bestCell < 0 ? 255 : bestCell) << 32
+        | (uint64_t)generation << 40;
+}
+
+static inline uint8_t sharedGenerationOf(uint64_t data){
+    return (uint8_t)(data >> 40);
+}
+
+SharedTranspositionTable *createSharedTranspositionTable(size_t size){
+    size_t actualSize = 1;
+    while(actualSize < size)
+        actualSize <<= 1;
+
+    SharedTranspositionTable *table = malloc(sizeof(SharedTranspositionTable));
+    SharedTTSlot *slots = calloc(actualSize, sizeof(SharedTTSlot));
+
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if (unlikely(table == NULL || slots == NULL)) {
+        fprintf(stderr, "Memory allocation failed in createSharedTranspositionTable! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+
+    table->slots = slots;
+    table->size = actualSize;
+    // calloc leaves every slot at generation 0, start at 1 so they all read as empty
+    table->generation = 1;
+    return table;
+}
+
+void destroySharedTranspositionTable(SharedTranspositionTable *table){
+    if(table == NULL)
+        return;
+    free(table->slots);
+    free(table);
+}
+
+void newSharedSearchGeneration(SharedTranspositionTable *table){
+    table->generation++;
+    // generation 0 is reserved for never written slots, clear everything on wrap around
+    if(unlikely(table->generation == 0)){
+        for(size_t i = 0; i < table->size; i++){
+            atomic_store_explicit(&table->slots[i].check, 0, memory_order_relaxed);
+            atomic_store_explicit(&table->slots[i].data, 0, memory_order_relaxed);
+        }
+        table->generation = 1;
+    }
+}
+
+bool probeSharedTable(SharedTranspositionTable *table, uint64_t key, SharedTTEntry *entry){
+    SharedTTSlot *slot = &table->slots[key & (table->size - 1)];
+    uint64_t data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+    // a different position, or half of another thread's write
+    if((check ^ data) != key || sharedGenerationOf(data) != table->generation)
+        return false;
+
+    entry->value = (int16_t)(uint16_t)(data & 0xFFFF);
+    entry->bound = (BoundType)((data >> 16) & 3);
+    entry->depth = (int)((data >> 24) & 0xFF);
+    uint8_t cell = (uint8_t)(data >> 32);
+    entry->bestCell = cell == 255 ? -1 : cell;
+    return true;
+}
+
+void storeSharedTable(SharedTranspositionTable *table, uint64_t key, int value, BoundType bound, int depth, int bestCell){
+    SharedTTSlot *slot = &table->slots[key & (table->size - 1)];
+    uint64_t old = atomic_load_explicit(&slot->data, memory_order_relaxed);
+    uint64_t oldCheck = atomic_load_explicit(&slot->check, memory_order_relaxed);
+    // keep a deeper result for the same position of this search, it took more work to find and cuts off more
+    if((oldCheck ^ old) == key && sharedGenerationOf(old) == table->generation && (int)((old >> 24) & 0xFF) > depth)
+        return;
+
+    uint64_t data = packSharedEntry(value, bound, depth, bestCell, table->generation);
+    atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+    atomic_store_explicit(&slot->check, key ^ data, memory_order_relaxed);
+}
@@ -3,8 +3,31 @@
 #include <include/game.h>
 #include <string.h>
 #include <include/deep_q.h>
+#include <include/mcts.h>
+#include <include/opening_book.h>
+#include <include/solved_database.h>
+#include <include/ultimate_search.h>
 
 bool aiDeepLearning = false;
+bool aiMonteCarlo = false;
+// the game being played, every rule function is handed this one
+static GameState gameState;
+// settings and memory of the AI searches, created by startGameUi
+static SearchContext *searchContext = NULL;
+static MctsContext *mctsContext = NULL;
+// when set, the cost of the last AI move is printed under the board
+static bool verbose = false;
+static bool hasAiStats = false;
+static SearchStats lastAiStats;
+// set when ultimate was picked as the board, gameState then mirrors the current position of ultimateGame
+static bool ultimateMode = false;
+static UltimateGame ultimateGame;
+// the AI had no legal move to play in a game that isn't over, it gives the game up instead of passing the turn back
+static void forfeitAiTurn(){
+    println("The AI couldn't find a move and forfeits the game.");
+    gameState.winner = gameState.player;
+}
+
 void endGameUi(){
     if(gameState.isDraw){
         println("Game Over! Draw!");
@@ -20,8 +43,28 @@ void endGameUi(){
     }
 }
 
-PlayerType selectOpponentTypeUi(){
-    bool valid_input;
+BoardConfig selectBoardSizeUi(){
+    int input = 0;
+    // ultimate is the option after the presets
+    while(input < 1 || input > BOARD_PRESET_COUNT + 1){
+        println("Select Board:");
+        for(int i = 0; i < BOARD_PRESET_COUNT; i++){
+            println("%d. %dx%d, %d in a row", i + 1, BOARD_PRESETS[i].size, BOARD_PRESETS[i].size, BOARD_PRESETS[i].winLength);
+        }
+        println("%d. Ultimate, 3x3 of 3x3", BOARD_PRESET_COUNT + 1);
+        if(scanf("%d", &input) != 1 || input < 1 || input > BOARD_PRESET_COUNT + 1){
+            input = 0;
+            println("Sorry, that input wasn't valid. Try again.");
+            clearInputBuffer();
+        }
+    }
+    clearScreen();
+    ultimateMode = input == BOARD_PRESET_COUNT + 1;
+    return ultimateMode ? (BoardConfig){ULTIMATE_SIZE, 3} : BOARD_PRESETS[input - 1];
+}
+
+PlayerType selectOpponentTypeUi(BoardConfig config){
+    bool valid_input = false;
     int input;
     PlayerType opponent;
     while(!valid_input){
@@ -29,6 +72,7 @@ PlayerType selectOpponentTypeUi(){
         println("1. Multiplayer");
         println("2. AI Player (Minimax)");
         println("3. Deep-Q Learning AI Player");
+        println("4. Monte Carlo Tree Search AI Player");
         scanf("%d", &input);
 
         switch(input){
@@ -40,11 +84,25 @@ PlayerType selectOpponentTypeUi(){
                 valid_input = true;
                 opponent = AI;
                 aiDeepLearning = false;
+                aiMonteCarlo = false;
                 break;
             case 3:
+                // the q-learning model was only trained on 3x3
+                if(!isClassicBoard(config)){
+                    println("The Deep-Q Learning AI only plays 3x3. Try again.");
+                    valid_input = false;
+                    break;
+                }
                 valid_input = true;
                 opponent = AI;
                 aiDeepLearning = true;
+                aiMonteCarlo = false;
+                break;
+            case 4:
+                valid_input = true;
+                opponent = AI;
+                aiDeepLearning = false;
+                aiMonteCarlo = true;
                 break;
             default:
                 valid_input = false;
@@ -53,7 +111,7 @@ PlayerType selectOpponentTypeUi(){
     }
     clearScreen();
     valid_input = false;
-    // ask for difficulty only when playing minimax
+    // ask for difficulty only when playing minimax or monte carlo
     while(!valid_input && opponent == AI && !aiDeepLearning){
         println("Select Difficulty:");
         println("1. Easy");
@@ -62,11 +120,13 @@ PlayerType selectOpponentTypeUi(){
         switch(input){
             case 1:
                 valid_input = true;
-                MAX_DEPTH = 2;
+                searchContext->maxDepth = 2;
+                mctsContext->playouts = MCTS_EASY_PLAYOUTS;
                 break;
             case 2:
                 valid_input = true;
-                MAX_DEPTH = 9;
+                searchContext->maxDepth = CLASSIC_MAX_DEPTH;
+                mctsContext->playouts = 0;
                 break;
             default:
                 valid_input = false;
@@ -81,8 +141,9 @@ PlayerType selectOpponentTypeUi(){
 }
 
 void selectMoveUi(){
-    bool option1_valid;
-    char option1[2];
+    bool option1_valid = false;
+    char option1[8];
+    int size = gameState.config.size;
     int col;
     int row;
     while(!option1_valid){
@@ -90,59 +151,27 @@ void selectMoveUi(){
         println("Select Next Move");
         println("Valid Input example : \"A3\"");
         println("-----------------------------");
-        scanf("%s", &option1);
-        char colchar = toupper(option1[0]);
-        char rowchar = option1[1];
-        switch (colchar)
-        {
-        case 'A':
-            col = 0;
-            option1_valid = true;
-            break;
-        case 'B':
-            col = 1;
-            option1_valid = true;
-            break;
-        case 'C':
-            col = 2;
-            option1_valid = true;
-            break;
-        
-        default:
-            option1_valid = false;
+        scanf("%7s", option1);
+        // letter picks the column (A, B, C...), the number after it the row (1, 2, 3...)
+        col = toupper(option1[0]) - 'A';
+        row = atoi(&option1[1]) - 1;
+        option1_valid = col >= 0 && col < size && row >= 0 && row < size;
+        if(!option1_valid){
             println("Sorry, that input wasn't valid. Try again.");
             clearInputBuffer();
-            break;
-        }
-
-        if(!option1_valid)
-            continue;
-
-        switch (rowchar)
-        {
-        case '1':
-            row = 0;
-            option1_valid = true;
-            break;
-        case '2':
-            row = 1;
-            option1_valid = true;
-            break;
-        case '3':
-            row = 2;
-            option1_valid = true;
-            break;
-        default:
-            option1_valid = false;
-            println("Sorry, that input wasn't valid. Try again.");
-            clearInputBuffer();
-            break;
         }
     }
-    bool moveSuccess = doMove(row, col);
-    if(moveSuccess)
-        nextTurn();
-    else{
+    bool moveSuccess;
+    if(ultimateMode){
+        moveSuccess = playUltimateGameMove(&ultimateGame, ultimateMoveAt(row, col));
+        if(moveSuccess)
+            syncUltimateGameState(&gameState, ultimateGameBoard(&ultimateGame));
+    }else{
+        moveSuccess = doMove(&gameState, row, col);
+        if(moveSuccess)
+            nextTurn(&gameState);
+    }
+    if(!moveSuccess){
         println("Move disallowed");
         selectMoveUi();
     }
@@ -151,26 +180,19 @@ void selectMoveUi(){
 void refreshUi(){
     clearScreen();
 
+    int size = gameState.config.size;
     printf("\n"); // Add an initial newline for spacing
-    printf("  1   2   3");
+    printf(" ");
+    for (int j = 0; j < size; j++) {
+        printf("%2d  ", j + 1);
+    }
     printf("\n");
 
     // add the column values for ui prettyness
-    for (int i = 0; i < 3; i++) {
-        char row_char;
-        switch(i){
-            case 0:
-                row_char = 'A';
-                break;
-            case 1:
-                row_char = 'B';
-                break;
-            case 2:
-                row_char = 'C';
-                break;
-        }
+    for (int i = 0; i < size; i++) {
+        char row_char = 'A' + i;
         printf("%c",row_char);
-        for (int j = 0; j < 3; j++) {
+        for (int j = 0; j < size; j++) {
 
             char character;
             switch(gameState.board[j][i]){
@@ -189,16 +211,42 @@ void refreshUi(){
             }
             // Center the character within its space
             printf(" %c ", character); 
-            if (j < 2) {
-                printf("|"); 
+            if (j < size - 1) {
+                // the small boards of ultimate are split by double lines
+                printf(ultimateMode && j % 3 == 2 ? "#" : "|");
             }
         }
         printf("\n");
-        if (i < 2) {
-            printf("---+---+---\n"); 
+        if (i < size - 1) {
+            bool blockEnd = ultimateMode && i % 3 == 2;
+            printf(" ");
+            for (int j = 0; j < size; j++) {
+                if (blockEnd)
+                    printf(j < size - 1 ? "===#" : "===");
+                else
+                    printf(j < size - 1 ? (ultimateMode && j % 3 == 2 ? "---#" : "---+") : "---");
+            }
+            printf("\n");
         }
     }
     printf("\n");
+
+    if(ultimateMode && gameState.winner == UNASSIGNED && !gameState.isDraw){
+        int forced = ultimateGameBoard(&ultimateGame)->forced;
+        if(forced == ULTIMATE_ANY_BOARD)
+            println("Next move: any open board");
+        else
+            println("Next move: the board from %c%d to %c%d", 'A' + forced % 3 * 3, forced / 3 * 3 + 1,
+                    'A' + forced % 3 * 3 + 2, forced / 3 * 3 + 3);
+        printf("\n");
+    }
+
+    if(verbose && hasAiStats){
+        char statsLine[160];
+        formatSearchStats(&lastAiStats, statsLine, sizeof(statsLine));
+        println("Last AI move: %s", statsLine);
+        printf("\n");
+    }
     
     if(gameState.turn == PLAYER_1 || gameState.turn == PLAYER_2){
         int menu_option1;
@@ -211,6 +259,7 @@ void refreshUi(){
             println("2) Surrender");
             println("3) Undo Previous Turn");
             println("4) Redo Previous Turn");
+            println("5) %s Search Stats", verbose ? "Hide" : "Show");
             println("-----------------------------");
             scanf("%d", &menu_option1);
             switch (menu_option1)
@@ -226,12 +275,23 @@ void refreshUi(){
                 endGameUi();
                 break;
             case 3:
-                undo();
+                if(ultimateMode)
+                    undoUltimateTurn(&gameState, &ultimateGame);
+                else
+                    undo(&gameState);
                 option1_valid = true;
                 refreshUi();
                 break;
             case 4:
-                redo();
+                if(ultimateMode)
+                    redoUltimateTurn(&gameState, &ultimateGame);
+                else
+                    redo(&gameState);
+                option1_valid = true;
+                refreshUi();
+                break;
+            case 5:
+                verbose = !verbose;
                 option1_valid = true;
                 refreshUi();
                 break;
@@ -243,22 +303,58 @@ void refreshUi(){
             }
         }
     }else if(gameState.turn == AI){
-        int t_board[3][3];
+        int t_board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
         memcpy(t_board, gameState.board, sizeof(gameState.board));
         Pair pair; 
-        if(aiDeepLearning){
+        if(ultimateMode){
+            // every AI plays ultimate with its own engine, none of the others know the rules
+            pair = findBestUltimateMove(searchContext, ultimateGameBoard(&ultimateGame), DEFAULT_MOVE_BUDGET_MS);
+            lastAiStats = searchContext->stats;
+            hasAiStats = true;
+            if(pair.a < 0 || !playUltimateGameMove(&ultimateGame, ultimateMoveAt(pair.a, pair.b))){
+                forfeitAiTurn();
+                return;
+            }
+            syncUltimateGameState(&gameState, ultimateGameBoard(&ultimateGame));
+            return;
+        }else if(aiDeepLearning){
             pair = findBestDLMove(t_board, gameState.turn, gameState.player1StartFirst);
+            lastAiStats = dlStats;
+        }else if(aiMonteCarlo){
+            pair = findBestMCTSMove(mctsContext, t_board, gameState.config, gameState.turn, gameState.player1StartFirst);
+            lastAiStats = mctsContext->stats;
         }else{
-            pair = findBestMove(t_board, gameState.turn, gameState.player1StartFirst);
+            pair = findBestMove(searchContext, t_board, gameState.config, gameState.turn, gameState.player1StartFirst);
+            lastAiStats = searchContext->stats;
+        }
+        hasAiStats = true;
+        if(!doMove(&gameState, pair.a, pair.b)){
+            forfeitAiTurn();
+            return;
         }
-        doMove(pair.a, pair.b);
-        nextTurn();
+        nextTurn(&gameState);
     }
 }
 
 void startGameUi(){
-    PlayerType opponent = selectOpponentTypeUi();
-    createGameState(opponent);
+    if(searchContext == NULL){
+        searchContext = createSearchContext(2, cpuCount());
+        // kept open for the rest of the program like the contexts, pages are only loaded when a probe needs them
+        searchContext->book = openOpeningBook(OPENING_BOOK_PATH);
+        searchContext->database = openPresetDatabase();
+        mctsContext = createMctsContext(MCTS_EASY_PLAYOUTS, DEFAULT_MOVE_BUDGET_MS);
+    }
+    BoardConfig config = selectBoardSizeUi();
+    PlayerType opponent = selectOpponentTypeUi(config);
+    if(ultimateMode){
+        // ultimate keeps its own rules and only copies its board into gameState
+        createMirroredGameState(&gameState, opponent, config);
+        newUltimateGame(&ultimateGame);
+        syncUltimateGameState(&gameState, ultimateGameBoard(&ultimateGame));
+    }else{
+        createGameState(&gameState, opponent, config);
+    }
+    hasAiStats = false;
     if(gameState.player1StartFirst){
         println("Player 1 Starts First, First Player Always X (Cross)");
     }else{
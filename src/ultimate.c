@@ -0,0 +1,194 @@
+#include <include/ultimate.h>
+#include <include/game.h>
+#include <string.h>
+
+// index of the lowest set bit of a non-zero mask
+static inline int lowestCell(uint16_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int cell = 0;
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        cell++;
+    }
+    return cell;
+#endif
+}
+
+void initUltimateBoard(UltimateBoard *board)
+{
+    memset(board, 0, sizeof(UltimateBoard));
+    board->forced = ULTIMATE_ANY_BOARD;
+    board->toMove = BOARD_CROSS;
+    board->winner = BOARD_EMPTY;
+}
+
+int generateUltimateMoves(const UltimateBoard *board, uint8_t moves[ULTIMATE_CELLS])
+{
+    if (board->winner != BOARD_EMPTY)
+        return 0;
+
+    // either the one board the last move sent us to, or every open board
+    uint16_t open = board->forced == ULTIMATE_ANY_BOARD ? (uint16_t)(~board->closed & BITBOARD_FULL) : (uint16_t)(1u << board->forced);
+    int count = 0;
+    while (open != 0)
+    {
+        int sub = lowestCell(open);
+        open &= open - 1;
+        uint16_t empty = ~occupiedCells(board->boards[sub]) & BITBOARD_FULL;
+        while (empty != 0)
+        {
+            moves[count++] = (uint8_t)(sub * 9 + lowestCell(empty));
+            empty &= empty - 1;
+        }
+    }
+    return count;
+}
+
+bool isUltimateMoveLegal(const UltimateBoard *board, int move)
+{
+    if (board->winner != BOARD_EMPTY || move < 0 || move >= ULTIMATE_CELLS)
+        return false;
+    int sub = move / 9;
+    if (board->closed & (1u << sub))
+        return false;
+    if (board->forced != ULTIMATE_ANY_BOARD && board->forced != sub)
+        return false;
+    return (occupiedCells(board->boards[sub]) & (1u << (move % 9))) == 0;
+}
+
+void playUltimateMove(UltimateBoard *board, int move)
+{
+    int sub = move / 9;
+    int cell = move % 9;
+    uint16_t bit = (uint16_t)(1u << cell);
+    uint16_t subBit = (uint16_t)(1u << sub);
+    Bitboard *small = &board->boards[sub];
+    bool cross = board->toMove == BOARD_CROSS;
+
+    uint16_t mine;
+    if (cross)
+    {
+        small->cross |= bit;
+        mine = small->cross;
+    }
+    else
+    {
+        small->nought |= bit;
+        mine = small->nought;
+    }
+
+    // only the board that was just played in can close, and only a new small win can win the game
+    if (hasWinningLine(mine))
+    {
+        board->closed |= subBit;
+        uint16_t macro;
+        if (cross)
+            macro = board->macro.cross |= subBit;
+        else
+            macro = board->macro.nought |= subBit;
+        if (hasWinningLine(macro))
+            board->winner = board->toMove;
+    }
+    else if (isBitboardFull(*small))
+    {
+        board->closed |= subBit;
+    }
+    if (board->winner == BOARD_EMPTY && board->closed == BITBOARD_FULL)
+        board->winner = ULTIMATE_DRAW;
+
+    // the cell picks the opponent's board, unless that one is closed
+    board->forced = (board->closed & bit) ? ULTIMATE_ANY_BOARD : (int8_t)cell;
+    board->toMove = cross ? BOARD_NOUGHT : BOARD_CROSS;
+    board->movesMade++;
+}
+
+int ultimatePieceAt(const UltimateBoard *board, int row, int col)
+{
+    int move = ultimateMoveAt(row, col);
+    Bitboard small = board->boards[move / 9];
+    uint16_t bit = (uint16_t)(1u << (move % 9));
+    if (small.cross & bit)
+        return BOARD_CROSS;
+    if (small.nought & bit)
+        return BOARD_NOUGHT;
+    return BOARD_EMPTY;
+}
+
+void newUltimateGame(UltimateGame *game)
+{
+    initUltimateBoard(&game->positions[0]);
+    game->current = 0;
+    game->last = 0;
+}
+
+bool playUltimateGameMove(UltimateGame *game, int move)
+{
+    if (!isUltimateMoveLegal(ultimateGameBoard(game), move))
+        return false;
+    game->positions[game->current + 1] = game->positions[game->current];
+    playUltimateMove(&game->positions[game->current + 1], move);
+    game->moves[game->current] = move;
+    game->current++;
+    game->last = game->current;
+    return true;
+}
+
+void undoUltimateGameMove(UltimateGame *game)
+{
+    if (game->current > 0)
+        game->current--;
+}
+
+void redoUltimateGameMove(UltimateGame *game)
+{
+    if (game->current < game->last)
+        game->current++;
+}
+
+void syncUltimateGameState(GameState *state, const UltimateBoard *board)
+{
+    PlayerType crossPlayer = state->player1StartFirst ? state->player : state->opponent;
+    PlayerType noughtPlayer = state->player1StartFirst ? state->opponent : state->player;
+    state->turn = board->toMove == BOARD_CROSS ? crossPlayer : noughtPlayer;
+    state->isDraw = board->winner == ULTIMATE_DRAW;
+    if (board->winner == BOARD_CROSS)
+        state->winner = crossPlayer;
+    else if (board->winner == BOARD_NOUGHT)
+        state->winner = noughtPlayer;
+    else
+        state->winner = UNASSIGNED;
+
+    for (int row = 0; row < ULTIMATE_SIZE; row++)
+        for (int col = 0; col < ULTIMATE_SIZE; col++)
+            state->board[row][col] = ultimatePieceAt(board, row, col);
+    state->movesMade = board->movesMade;
+}
+
+void undoUltimateTurn(GameState *state, UltimateGame *game)
+{
+    bool againstAi = state->opponent == AI;
+    // when the AI started, its first move stays on the board like in undo
+    int firstMove = againstAi && !state->player1StartFirst ? 1 : 0;
+    if (game->current <= firstMove)
+        return;
+    do
+    {
+        undoUltimateGameMove(game);
+        syncUltimateGameState(state, ultimateGameBoard(game));
+    } while (againstAi && state->turn == state->opponent && game->current > firstMove);
+}
+
+void redoUltimateTurn(GameState *state, UltimateGame *game)
+{
+    if (game->current == game->last)
+        return;
+    do
+    {
+        redoUltimateGameMove(game);
+        syncUltimateGameState(state, ultimateGameBoard(game));
+    } while (state->opponent == AI && state->turn == state->opponent && game->current < game->last);
+}
@@ -0,0 +1,231 @@
+#include <include/ultimate_search.h>
+#include <ultimate_tables.h>
+#include <string.h>
+
+// evaluation weights, a won small board is worth far more than anything inside the open ones. the lines inside an open
+// small board are scored by ULTIMATE_SMALL_SCORES, generated with its own weights by tools/gen_board_tables.c
+#define SMALL_BOARD_WON 100
+#define MACRO_TWO_IN_ROW 150
+#define FREE_MOVE_BONUS 20
+
+// how often the search looks at the clock, in nodes
+#define CLOCK_CHECK_INTERVAL 1024
+
+// number of winning lines through each cell of a 3x3 board, how much a cell or a small board is worth
+static const int CELL_LINES[9] = {3, 2, 3, 2, 4, 2, 3, 2, 3};
+
+int evaluateUltimateBoard(const UltimateBoard *board)
+{
+    int score = 0;
+    uint16_t drawn = board->closed & ~(board->macro.cross | board->macro.nought);
+    for (int sub = 0; sub < 9; sub++)
+    {
+        uint16_t bit = (uint16_t)(1u << sub);
+        if (board->macro.cross & bit)
+            score += SMALL_BOARD_WON + CELL_LINES[sub] * 10;
+        else if (board->macro.nought & bit)
+            score -= SMALL_BOARD_WON + CELL_LINES[sub] * 10;
+        else if (!(board->closed & bit))
+        {
+            Bitboard small = board->boards[sub];
+            score += ULTIMATE_SMALL_SCORES[ULTIMATE_BASE3[small.cross] + 2 * ULTIMATE_BASE3[small.nought]] * CELL_LINES[sub];
+        }
+    }
+
+    // two won boards in a row on the big board, as long as the third one can still be won
+    for (int i = 0; i < WIN_LINE_COUNT; i++)
+    {
+        uint16_t line = WIN_LINES[i];
+        if (drawn & line)
+            continue;
+        int crosses = BIT_COUNTS[board->macro.cross & line];
+        int noughts = BIT_COUNTS[board->macro.nought & line];
+        if (crosses == 2 && noughts == 0)
+            score += MACRO_TWO_IN_ROW;
+        else if (noughts == 2 && crosses == 0)
+            score -= MACRO_TWO_IN_ROW;
+    }
+
+    if (board->toMove == BOARD_NOUGHT)
+        score = -score;
+    // picking any board is worth a lot more than being sent to one
+    if (board->forced == ULTIMATE_ANY_BOARD)
+        score += FREE_MOVE_BONUS;
+    return score;
+}
+
+/// @brief State of one search, the board itself is copied down the tree.
+typedef struct UltimateSearch{
+    SearchContext *context;
+    SearchStats stats;
+    long long deadline; // currentTimeMillis when the search has to stop, 0 for none
+    bool aborted; // set once the deadline has passed or the search was cancelled, every node returns straight away after that
+    int rootBest; // best move of the last finished depth, tried first at the root
+}UltimateSearch;
+
+static inline bool isAborted(UltimateSearch *search)
+{
+    if (!search->aborted && (search->stats.nodes % CLOCK_CHECK_INTERVAL) == 0)
+    {
+        if (atomic_load_explicit(&search->context->cancelled, memory_order_relaxed)
+            || (search->deadline != 0 && currentTimeMillis() >= search->deadline))
+            search->aborted = true;
+    }
+    return search->aborted;
+}
+
+// sorts moves best first: winning a small board, then blocking one, and last the moves that send the opponent
+// to a board they win straight away or let them pick any board. first is tried before everything if it is legal.
+static void orderMoves(const UltimateBoard *board, uint8_t *moves, int count, int first)
+{
+    int scores[ULTIMATE_CELLS];
+    bool cross = board->toMove == BOARD_CROSS;
+    for (int i = 0; i < count; i++)
+    {
+        int sub = moves[i] / 9;
+        int cell = moves[i] % 9;
+        uint16_t bit = (uint16_t)(1u << cell);
+        Bitboard small = board->boards[sub];
+        uint16_t mine = cross ? small.cross : small.nought;
+        uint16_t theirs = cross ? small.nought : small.cross;
+
+        int score = CELL_LINES[cell];
+        if (hasWinningLine(mine | bit))
+            score += 100 + CELL_LINES[sub] * 10;
+        else if (hasWinningLine(theirs | bit))
+            score += 50;
+
+        // where the opponent goes next
+        if (board->closed & bit)
+        {
+            // a closed board lets them pick any
+            score -= 30;
+        }
+        else
+        {
+            Bitboard next = board->boards[cell];
+            uint16_t nextTheirs = cross ? next.nought : next.cross;
+            uint16_t nextEmpty = ~occupiedCells(next) & BITBOARD_FULL;
+            for (int j = 0; j < WIN_LINE_COUNT; j++)
+            {
+                uint16_t open = WIN_LINES[j] & nextEmpty;
+                if (BIT_COUNTS[open] == 1 && (nextTheirs & WIN_LINES[j]) == (WIN_LINES[j] & ~open))
+                {
+                    score -= 40;
+                    break;
+                }
+            }
+        }
+        if (moves[i] == first)
+            score += 1000;
+        scores[i] = score;
+    }
+
+    // insertion sort, at most 81 moves and usually 9 or fewer
+    for (int i = 1; i < count; i++)
+    {
+        uint8_t move = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score)
+        {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+static int negamax(UltimateSearch *search, const UltimateBoard *board, int depth, int ply, int alpha, int beta)
+{
+    search->stats.nodes++;
+    if (ply + 1 > search->stats.maxDepth)
+        search->stats.maxDepth = ply + 1;
+
+    // the side that just moved ended the game
+    if (board->winner != BOARD_EMPTY)
+        return board->winner == ULTIMATE_DRAW ? 0 : -(ULTIMATE_WIN_SCORE - ply);
+    if (depth == 0)
+        return evaluateUltimateBoard(board);
+    if (isAborted(search))
+        return 0;
+
+    uint8_t moves[ULTIMATE_CELLS];
+    int count = generateUltimateMoves(board, moves);
+    orderMoves(board, moves, count, ply == 0 ? search->rootBest : -1);
+
+    int best = -ULTIMATE_WIN_SCORE - 1;
+    for (int i = 0; i < count; i++)
+    {
+        UltimateBoard child = *board;
+        playUltimateMove(&child, moves[i]);
+        int value = -negamax(search, &child, depth - 1, ply + 1, -beta, -alpha);
+        if (search->aborted)
+            return 0;
+        if (value > best)
+        {
+            best = value;
+            if (ply == 0)
+                search->rootBest = moves[i];
+        }
+        if (best > alpha)
+            alpha = best;
+        if (alpha >= beta)
+        {
+            search->stats.cutoffs++;
+            break;
+        }
+    }
+    return best;
+}
+
+Pair findBestUltimateMove(SearchContext *context, const UltimateBoard *board, int budgetMs)
+{
+    long long startMicros = currentTimeMicros();
+    long long start = currentTimeMillis();
+
+    UltimateSearch search;
+    search.context = context;
+    search.stats = (SearchStats){0};
+    search.aborted = false;
+    search.rootBest = -1;
+
+    uint8_t moves[ULTIMATE_CELLS];
+    int count = generateUltimateMoves(board, moves);
+    int bestMove = -1;
+    if (count > 0)
+    {
+        // if not even depth 1 finishes, any legal move beats no move at all
+        orderMoves(board, moves, count, -1);
+        bestMove = moves[0];
+
+        bool timed = context->maxDepth >= CLASSIC_MAX_DEPTH;
+        int maxDepth = timed ? ULTIMATE_CELLS - board->movesMade : context->maxDepth;
+        search.deadline = timed ? start + budgetMs : 0;
+        for (int depth = 1; depth <= maxDepth; depth++)
+        {
+            search.rootBest = bestMove;
+            int value = negamax(&search, board, depth, 0, -ULTIMATE_WIN_SCORE - 1, ULTIMATE_WIN_SCORE + 1);
+            if (search.aborted)
+                break;
+            bestMove = search.rootBest;
+
+            // a forced win or loss won't change with more depth
+            if (abs(value) >= ULTIMATE_WIN_SCORE - ULTIMATE_CELLS)
+                break;
+
+            // the next depth costs several times this one, don't start it if it can't finish
+            if (timed && (currentTimeMillis() - start) * 2 >= budgetMs)
+                break;
+        }
+    }
+
+    context->stats = search.stats;
+    context->stats.timeMs = (currentTimeMicros() - startMicros) / 1000.0;
+    Pair pair;
+    pair.a = bestMove < 0 ? -1 : ultimateMoveRow(bestMove);
+    pair.b = bestMove < 0 ? -1 : ultimateMoveCol(bestMove);
+    return pair;
+}
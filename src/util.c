@@ -1,4 +1,12 @@
 #include <util.h>
+#ifdef _WIN32
+// keep windows.h from defining max and min macros, they would clash with the functions below
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
 
 inline void println(const char *format, ...) {
   va_list args;
@@ -35,4 +43,45 @@ int max(int a, int b) {
 /// @return 
 int min(int a, int b) {
     return (a < b) ? a : b;
-}
\ No newline at end of file
+}
+
+long long currentTimeMillis() {
+    #ifdef _WIN32
+        return (long long)GetTickCount64();
+    #else
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    #endif
+}
+
+long long currentTimeMicros() {
+    #ifdef _WIN32
+        LARGE_INTEGER frequency, now;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&now);
+        // whole seconds and the remainder separately, multiplying the raw count by a million could overflow
+        return (long long)(now.QuadPart / frequency.QuadPart * 1000000 + now.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+    #else
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    #endif
+}
+
+void formatSearchStats(const SearchStats *stats, char *buffer, size_t size) {
+    // nodes per millisecond is thousands of nodes per second
+    double knps = stats->timeMs > 0 ? stats->nodes / stats->timeMs : 0;
+    snprintf(buffer, size, "nodes %llu | depth %d | cutoffs %llu | hash hits %llu | %.2f ms | %.0f knodes/s",
+             stats->nodes, stats->maxDepth, stats->cutoffs, stats->hashHits, stats->timeMs, knps);
+}
+
+int cpuCount() {
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return max(1, (int)info.dwNumberOfProcessors);
+    #else
+        return max(1, (int)sysconf(_SC_NPROCESSORS_ONLN));
+    #endif
+}
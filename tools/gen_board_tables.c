@@ -0,0 +1,422 @@
+// Build step that works out the geometry of every board the game knows and writes it as constant tables, so the rules
+// and searches look lines, symmetries and move orders up instead of computing them at runtime.
+// usage: gen_board_tables <board_tables.h> <line_tables.h> <ultimate_tables.h>
+//        gen_board_tables --python <board_tables.py>
+//
+// board_tables.h only needs stdint.h and is included by bitboard.h and qubic.h. line_tables.h holds a LineTable per
+// board preset and is included by game.c after game.h. ultimate_tables.h holds the small board score table of ultimate
+// and is only included by ultimate_search.c, the only place that reads it.
+// board_tables.py holds the win lines for python/ttt.py, which checks its own copy against them when a build is there.
+#include <stdlib.h>
+#include <string.h>
+#include <include/game.h>
+
+static const BoardConfig PRESETS[] = {BOARD_PRESET_LIST};
+#define PRESET_COUNT (int)(sizeof(PRESETS) / sizeof(PRESETS[0]))
+
+// the 4 line directions through a cell: horizontal, vertical and both diagonals, in the order of buildLineTable
+static const int LINE_DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+// where (row, col) of a 3x3 board ends up under symmetry s: rotations 0, 90, 180, 270, mirror left-right,
+// mirror top-bottom, main diagonal, anti diagonal
+static int transformCell(int s, int row, int col){
+    int r, c;
+    switch(s){
+        case 0: r = row; c = col; break;
+        case 1: r = col; c = 2 - row; break;
+        case 2: r = 2 - row; c = 2 - col; break;
+        case 3: r = 2 - col; c = row; break;
+        case 4: r = row; c = 2 - col; break;
+        case 5: r = 2 - row; c = col; break;
+        case 6: r = col; c = row; break;
+        default: r = 2 - col; c = 2 - row; break;
+    }
+    return r * 3 + c;
+}
+
+// the lines of an m,n,k board, in the same order buildLineTable finds them
+static void buildLines(BoardConfig config, LineTable *table){
+    int size = config.size;
+    int span = config.winLength - 1;
+    memset(table, 0, sizeof(LineTable));
+    table->config = config;
+    for(int row = 0; row < size; row++){
+        for(int col = 0; col < size; col++){
+            for(int d = 0; d < 4; d++){
+                int endRow = row + span * LINE_DIRECTIONS[d][0];
+                int endCol = col + span * LINE_DIRECTIONS[d][1];
+                if(endRow >= size || endCol < 0 || endCol >= size)
+                    continue;
+                int line = table->lineCount++;
+                table->lineStart[line] = (int16_t)(row * MAX_BOARD_SIZE + col);
+                table->lineStep[line] = (int16_t)(LINE_DIRECTIONS[d][0] * MAX_BOARD_SIZE + LINE_DIRECTIONS[d][1]);
+                for(int i = 0; i < config.winLength; i++){
+                    int cell = table->lineStart[line] + i * table->lineStep[line];
+                    table->cellLines[cell][table->cellLineCount[cell]++] = (int16_t)line;
+                }
+            }
+        }
+    }
+}
+
+// cells as row * size + col sorted by distance to the center, ties in row-major order, like computeCenterOrder
+static void buildCenterOrder(int size, int order[MAX_BOARD_SIZE * MAX_BOARD_SIZE]){
+    int distance[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    for(int cell = 0; cell < size * size; cell++){
+        // doubled coordinates keep the center of even sized boards on integers
+        int dr = abs(2 * (cell / size) - (size - 1));
+        int dc = abs(2 * (cell % size) - (size - 1));
+        distance[cell] = (dr > dc ? dr : dc) * 4 * MAX_BOARD_SIZE + dr + dc;
+        int i = cell;
+        while(i > 0 && distance[order[i - 1]] > distance[cell]){
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = cell;
+    }
+}
+
+// the lines of the 3,3 board as masks of bit row * 3 + col, in the order of buildLineTable
+static void buildClassicLines(uint16_t lines[8]){
+    LineTable classic;
+    buildLines((BoardConfig){3, 3}, &classic);
+    for(int i = 0; i < classic.lineCount; i++){
+        lines[i] = 0;
+        for(int k = 0; k < 3; k++){
+            int cell = classic.lineStart[i] + k * classic.lineStep[i];
+            lines[i] |= (uint16_t)(1u << (cell / MAX_BOARD_SIZE * 3 + cell % MAX_BOARD_SIZE));
+        }
+    }
+}
+
+// prints count numbers as a braced list, 16 per row
+static void printValues(FILE *out, const char *format, const long long *values, int count, const char *indent){
+    fprintf(out, "{");
+    for(int i = 0; i < count; i++){
+        if(i % 16 == 0)
+            fprintf(out, "\n%s    ", indent);
+        else
+            fprintf(out, " ");
+        fprintf(out, format, values[i]);
+        if(i != count - 1)
+            fprintf(out, ",");
+    }
+    fprintf(out, "\n%s}", indent);
+}
+
+static void writeBoardTables(FILE *out){
+    long long values[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    fprintf(out, "// Generated by tools/gen_board_tables.c, do not edit.\n");
+    fprintf(out, "#include <stdint.h>\n\n#ifndef BOARD_TABLES_H\n#define BOARD_TABLES_H\n\n");
+
+    // classic 3x3: the lines of the 3,3 board as masks of bit row * 3 + col
+    LineTable classic;
+    buildLines((BoardConfig){3, 3}, &classic);
+    uint16_t lines[8];
+    buildClassicLines(lines);
+    for(int i = 0; i < 8; i++)
+        values[i] = lines[i];
+    fprintf(out, "/// @brief The 8 winning lines of the 3x3 board as cell masks, a side has won if one is fully covered by its mask.\n");
+    fprintf(out, "static const uint16_t WIN_LINES[8] = ");
+    printValues(out, "0x%03llx", values, 8, "");
+    fprintf(out, ";\n\n");
+
+    uint32_t winning[16] = {0};
+    for(int mask = 0; mask < 512; mask++){
+        for(int i = 0; i < 8; i++){
+            if((mask & lines[i]) == lines[i])
+                winning[mask >> 5] |= 1u << (mask & 31);
+        }
+    }
+    for(int i = 0; i < 16; i++)
+        values[i] = winning[i];
+    fprintf(out, "/// @brief Bit (mask & 31) of WINNING_MASKS[mask >> 5] is set when the 9 bit mask covers a winning line.\n");
+    fprintf(out, "static const uint32_t WINNING_MASKS[16] = ");
+    printValues(out, "0x%08llx", values, 16, "");
+    fprintf(out, ";\n\n");
+
+    int symmetry[8][9];
+    for(int s = 0; s < 8; s++)
+        for(int cell = 0; cell < 9; cell++)
+            symmetry[s][cell] = transformCell(s, cell / 3, cell % 3);
+    fprintf(out, "/// @brief SYMMETRY_CELLS[s][cell] is where cell ends up under symmetry s (rotations 0, 90, 180, 270, then the 4 reflections).\n");
+    fprintf(out, "static const int SYMMETRY_CELLS[8][9] = {\n");
+    for(int s = 0; s < 8; s++){
+        fprintf(out, "    {");
+        for(int cell = 0; cell < 9; cell++)
+            fprintf(out, "%d%s", symmetry[s][cell], cell == 8 ? "" : ", ");
+        fprintf(out, "}%s\n", s == 7 ? "" : ",");
+    }
+    fprintf(out, "};\n\n");
+
+    // the inverse of s is the symmetry that maps every cell back where it came from
+    for(int s = 0; s < 8; s++){
+        for(int t = 0; t < 8; t++){
+            bool inverse = true;
+            for(int cell = 0; cell < 9; cell++)
+                inverse &= symmetry[t][symmetry[s][cell]] == cell;
+            if(inverse)
+                values[s] = t;
+        }
+    }
+    fprintf(out, "/// @brief INVERSE_SYMMETRY[s] is the symmetry that undoes s.\n");
+    fprintf(out, "static const int INVERSE_SYMMETRY[8] = ");
+    printValues(out, "%lld", values, 8, "");
+    fprintf(out, ";\n\n");
+
+    fprintf(out, "/// @brief SYMMETRY_MASKS[s][mask] is the 9 bit mask transformed by symmetry s.\n");
+    fprintf(out, "static const uint16_t SYMMETRY_MASKS[8][512] = {\n");
+    for(int s = 0; s < 8; s++){
+        for(int mask = 0; mask < 512; mask++){
+            uint16_t transformed = 0;
+            for(int cell = 0; cell < 9; cell++)
+                if(mask & (1 << cell))
+                    transformed |= (uint16_t)(1u << symmetry[s][cell]);
+            fprintf(out, "%s0x%03x%s", mask % 16 == 0 ? (mask == 0 ? "    {\n        " : "\n        ") : " ", transformed, mask == 511 ? "" : ",");
+        }
+        fprintf(out, "\n    }%s\n", s == 7 ? "" : ",");
+    }
+    fprintf(out, "};\n\n");
+
+    // the cells on the most lines first: center, corners, edges
+    int moveOrder[9];
+    for(int cell = 0; cell < 9; cell++){
+        int lineCount = classic.cellLineCount[cell / 3 * MAX_BOARD_SIZE + cell % 3];
+        int i = cell;
+        while(i > 0 && classic.cellLineCount[moveOrder[i - 1] / 3 * MAX_BOARD_SIZE + moveOrder[i - 1] % 3] < lineCount){
+            moveOrder[i] = moveOrder[i - 1];
+            i--;
+        }
+        moveOrder[i] = cell;
+    }
+    for(int i = 0; i < 9; i++)
+        values[i] = moveOrder[i];
+    fprintf(out, "/// @brief Cells of the 3x3 board on the most lines first: center, corners, then edges.\n");
+    fprintf(out, "static const int CLASSIC_MOVE_ORDER[9] = ");
+    printValues(out, "%lld", values, 9, "");
+    fprintf(out, ";\n\n");
+
+    static long long counts[512];
+    for(int mask = 0; mask < 512; mask++){
+        counts[mask] = 0;
+        for(int bits = mask; bits != 0; bits &= bits - 1)
+            counts[mask]++;
+    }
+    fprintf(out, "/// @brief BIT_COUNTS[mask] is the number of cells in a 9 bit mask.\n");
+    fprintf(out, "static const uint8_t BIT_COUNTS[512] = ");
+    printValues(out, "%lld", counts, 512, "");
+    fprintf(out, ";\n\n");
+
+    fprintf(out, "// Number of board presets the tables below cover, the same as BOARD_PRESET_COUNT\n");
+    fprintf(out, "#define BOARD_TABLE_PRESETS %d\n\n", PRESET_COUNT);
+    fprintf(out, "/// @brief Cells of every board preset as row * size + col, closest to the center first. Ties stay in row-major order.\n");
+    fprintf(out, "static const int16_t PRESET_CENTER_ORDERS[%d][%d] = {\n", PRESET_COUNT, MAX_BOARD_SIZE * MAX_BOARD_SIZE);
+    for(int p = 0; p < PRESET_COUNT; p++){
+        int order[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+        int size = PRESETS[p].size;
+        buildCenterOrder(size, order);
+        for(int i = 0; i < size * size; i++)
+            values[i] = order[i];
+        fprintf(out, "    // %dx%d\n    ", size, size);
+        printValues(out, "%lld", values, size * size, "    ");
+        fprintf(out, "%s\n", p == PRESET_COUNT - 1 ? "" : ",");
+    }
+    fprintf(out, "};\n\n");
+
+    // qubic: every start cell and direction a line of 4 fits in, one of each pair of opposite directions
+    uint64_t qubicLines[76];
+    int qubicLineCount = 0;
+    int cellLineCount[64] = {0};
+    int cellLines[64][7];
+    for(int dl = -1; dl <= 1; dl++){
+        for(int dr = -1; dr <= 1; dr++){
+            for(int dc = -1; dc <= 1; dc++){
+                int first = dl != 0 ? dl : dr != 0 ? dr : dc;
+                if(first <= 0)
+                    continue;
+                for(int cell = 0; cell < 64; cell++){
+                    int layer = cell / 16;
+                    int row = cell / 4 % 4;
+                    int col = cell % 4;
+                    // a moving coordinate has to start at the edge it moves away from
+                    if((dl == 1 && layer != 0) || (dl == -1 && layer != 3) || (dr == 1 && row != 0)
+                       || (dr == -1 && row != 3) || (dc == 1 && col != 0) || (dc == -1 && col != 3))
+                        continue;
+                    uint64_t line = 0;
+                    for(int i = 0; i < 4; i++){
+                        int c = (layer + i * dl) * 16 + (row + i * dr) * 4 + col + i * dc;
+                        line |= 1ull << c;
+                        cellLines[c][cellLineCount[c]++] = qubicLineCount;
+                    }
+                    qubicLines[qubicLineCount++] = line;
+                }
+            }
+        }
+    }
+    fprintf(out, "/// @brief The 76 lines of the 4x4x4 cube as masks of bit layer * 16 + row * 4 + col.\n");
+    fprintf(out, "static const uint64_t QUBIC_LINES[76] = {");
+    for(int i = 0; i < qubicLineCount; i++)
+        fprintf(out, "%s0x%016llxull%s", i % 4 == 0 ? "\n    " : " ", (unsigned long long)qubicLines[i], i == qubicLineCount - 1 ? "" : ",");
+    fprintf(out, "\n};\n\n");
+
+    for(int cell = 0; cell < 64; cell++)
+        values[cell] = cellLineCount[cell];
+    fprintf(out, "/// @brief Number of lines of the cube through every cell.\n");
+    fprintf(out, "static const uint8_t QUBIC_CELL_LINE_COUNT[64] = ");
+    printValues(out, "%lld", values, 64, "");
+    fprintf(out, ";\n\n");
+
+    fprintf(out, "/// @brief Indices into QUBIC_LINES of the lines through every cell.\n");
+    fprintf(out, "static const uint8_t QUBIC_CELL_LINES[64][7] = {\n");
+    for(int cell = 0; cell < 64; cell++){
+        fprintf(out, "    {");
+        for(int i = 0; i < cellLineCount[cell]; i++)
+            fprintf(out, "%d%s", cellLines[cell][i], i == cellLineCount[cell] - 1 ? "" : ", ");
+        fprintf(out, "}%s\n", cell == 63 ? "" : ",");
+    }
+    fprintf(out, "};\n\n#endif\n");
+}
+
+// worth of a line of an ultimate small board one side holds alone with two pieces or with one, see ULTIMATE_SMALL_SCORES.
+// the rest of the ultimate evaluation weights are in ultimate_search.c
+#define SMALL_TWO_IN_ROW 6
+#define SMALL_ONE_IN_ROW 1
+// 3 to the power of 9, every way to fill a small board with empty cells, crosses and noughts
+#define SMALL_POSITIONS 19683
+
+static void writeUltimateTables(FILE *out){
+    fprintf(out, "// Generated by tools/gen_board_tables.c, do not edit.\n");
+    fprintf(out, "#include <stdint.h>\n\n#ifndef ULTIMATE_TABLES_H\n#define ULTIMATE_TABLES_H\n\n");
+
+    // a small board in base 3, every cell is a digit that is 0 when empty, 1 for a cross and 2 for a nought
+    long long base3[512];
+    for(int mask = 0; mask < 512; mask++){
+        base3[mask] = 0;
+        for(int cell = 8; cell >= 0; cell--)
+            base3[mask] = base3[mask] * 3 + ((mask >> cell) & 1);
+    }
+    fprintf(out, "/// @brief ULTIMATE_BASE3[mask] reads the 9 bit mask as base 3 digits, so the crosses and noughts of a small board\n");
+    fprintf(out, "/// index ULTIMATE_SMALL_SCORES with ULTIMATE_BASE3[cross] + 2 * ULTIMATE_BASE3[nought].\n");
+    fprintf(out, "static const uint16_t ULTIMATE_BASE3[512] = ");
+    printValues(out, "%lld", base3, 512, "");
+    fprintf(out, ";\n\n");
+
+    // the lines of one small board either side could still complete, only positions that can occur get an index
+    uint16_t lines[8];
+    buildClassicLines(lines);
+    static long long smallScores[SMALL_POSITIONS];
+    for(int cross = 0; cross < 512; cross++){
+        for(int nought = 0; nought < 512; nought++){
+            // both sides on one cell never happens
+            if(cross & nought)
+                continue;
+            long long score = 0;
+            for(int i = 0; i < 8; i++){
+                int crosses = __builtin_popcount(cross & lines[i]);
+                int noughts = __builtin_popcount(nought & lines[i]);
+                // a line holding both pieces can't be completed by either side
+                if(noughts == 0)
+                    score += crosses == 2 ? SMALL_TWO_IN_ROW : crosses == 1 ? SMALL_ONE_IN_ROW : 0;
+                if(crosses == 0)
+                    score -= noughts == 2 ? SMALL_TWO_IN_ROW : noughts == 1 ? SMALL_ONE_IN_ROW : 0;
+            }
+            smallScores[base3[cross] + 2 * base3[nought]] = score;
+        }
+    }
+    fprintf(out, "/// @brief The two in a rows and single pieces of crosses minus noughts on one small board of ultimate, in the lines\n");
+    fprintf(out, "/// the other side hasn't blocked. Indexed in base 3, see ULTIMATE_BASE3.\n");
+    fprintf(out, "static const int16_t ULTIMATE_SMALL_SCORES[%d] = ", SMALL_POSITIONS);
+    printValues(out, "%lld", smallScores, SMALL_POSITIONS, "");
+    fprintf(out, ";\n\n");
+    fprintf(out, "#endif\n");
+}
+
+static void writePythonTables(FILE *out){
+    uint16_t lines[8];
+    buildClassicLines(lines);
+    fprintf(out, "# Generated by tools/gen_board_tables.c, do not edit. python/ttt.py checks its WIN_LINES against it.\n\n");
+    fprintf(out, "# The 8 winning lines of the 3x3 board as (row, col) cells, in the order of WIN_LINES in board_tables.h\n");
+    fprintf(out, "WIN_LINES = (\n");
+    for(int i = 0; i < 8; i++){
+        fprintf(out, "    (");
+        int written = 0;
+        for(int cell = 0; cell < 9; cell++){
+            if(lines[i] & (1u << cell))
+                fprintf(out, "(%d, %d)%s", cell / 3, cell % 3, ++written == 3 ? "" : ", ");
+        }
+        fprintf(out, "),\n");
+    }
+    fprintf(out, ")\n");
+}
+
+static void writeLineTables(FILE *out){
+    long long values[MAX_LINE_WINDOWS];
+    fprintf(out, "// Generated by tools/gen_board_tables.c, do not edit. Needs LineTable from game.h.\n");
+    fprintf(out, "#ifndef LINE_TABLES_H\n#define LINE_TABLES_H\n\n");
+    fprintf(out, "/// @brief Lines of every board preset, in the order of BOARD_PRESETS. Cells are row * MAX_BOARD_SIZE + col.\n");
+    fprintf(out, "static const LineTable PRESET_LINE_TABLES[%d] = {\n", PRESET_COUNT);
+    for(int p = 0; p < PRESET_COUNT; p++){
+        static LineTable table;
+        buildLines(PRESETS[p], &table);
+        fprintf(out, "    // %dx%d, %d in a row\n", PRESETS[p].size, PRESETS[p].size, PRESETS[p].winLength);
+        fprintf(out, "    {\n        .config = {%d, %d},\n        .lineCount = %d,\n", PRESETS[p].size, PRESETS[p].winLength, table.lineCount);
+        for(int i = 0; i < table.lineCount; i++)
+            values[i] = table.lineStart[i];
+        fprintf(out, "        .lineStart = ");
+        printValues(out, "%lld", values, table.lineCount, "        ");
+        for(int i = 0; i < table.lineCount; i++)
+            values[i] = table.lineStep[i];
+        fprintf(out, ",\n        .lineStep = ");
+        printValues(out, "%lld", values, table.lineCount, "        ");
+
+        // only the cells of the board, everything past it stays 0
+        fprintf(out, ",\n        .cellLineCount = {");
+        for(int cell = 0; cell < MAX_BOARD_SIZE * MAX_BOARD_SIZE; cell++)
+            if(table.cellLineCount[cell] != 0)
+                fprintf(out, "\n            [%d] = %d,", cell, table.cellLineCount[cell]);
+        fprintf(out, "\n        },\n        .cellLines = {");
+        for(int cell = 0; cell < MAX_BOARD_SIZE * MAX_BOARD_SIZE; cell++){
+            if(table.cellLineCount[cell] == 0)
+                continue;
+            fprintf(out, "\n            [%d] = {", cell);
+            for(int i = 0; i < table.cellLineCount[cell]; i++)
+                fprintf(out, "%d%s", table.cellLines[cell][i], i == table.cellLineCount[cell] - 1 ? "" : ", ");
+            fprintf(out, "},");
+        }
+        fprintf(out, "\n        }\n    }%s\n", p == PRESET_COUNT - 1 ? "" : ",");
+    }
+    fprintf(out, "};\n\n#endif\n");
+}
+
+int main(int argc, char **argv){
+    if(argc == 3 && strcmp(argv[1], "--python") == 0){
+        FILE *out = fopen(argv[2], "w");
+        if(out == NULL){
+            fprintf(stderr, "unable to open %s for writing\n", argv[2]);
+            return 1;
+        }
+        writePythonTables(out);
+        fclose(out);
+        return 0;
+    }
+    if(argc != 4){
+        fprintf(stderr, "usage: %s <board_tables.h> <line_tables.h> <ultimate_tables.h>\n", argv[0]);
+        fprintf(stderr, "       %s --python <board_tables.py>\n", argv[0]);
+        return 1;
+    }
+    for(int i = 0; i < 3; i++){
+        FILE *out = fopen(argv[i + 1], "w");
+        if(out == NULL){
+            fprintf(stderr, "unable to open %s for writing\n", argv[i + 1]);
+            return 1;
+        }
+        if(i == 0)
+            writeBoardTables(out);
+        else if(i == 1)
+            writeLineTables(out);
+        else
+            writeUltimateTables(out);
+        fclose(out);
+    }
+    return 0;
+}
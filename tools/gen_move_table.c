@@ -0,0 +1,104 @@
+// Build step that solves 3x3 tic-tac-toe completely and writes the perfect-play table used by findTableMove.
+// usage: gen_move_table <output.c>
+#include <include/bitboard.h>
+#include <include/move_table.h>
+
+static MoveTableEntry table[MOVE_TABLE_SIZE];
+static bool solved[MOVE_TABLE_SIZE];
+static uint16_t base3[512];
+
+static int indexOf(Bitboard board){
+    return base3[board.cross] + 2 * base3[board.nought];
+}
+
+/// @brief Negamax over the full game tree, memoized in table so every position is only solved once.
+/// @return value of the position for the side to move
+static int solve(Bitboard board){
+    int index = indexOf(board);
+    if(solved[index])
+        return table[index].value;
+
+    MoveTableEntry entry = {-1, 0};
+    bool crossToMove = __builtin_popcount(board.cross) == __builtin_popcount(board.nought);
+    uint16_t lastMover = crossToMove ? board.nought : board.cross;
+
+    if(hasWinningLine(lastMover)){
+        entry.value = -10; // the opponent just completed a line
+    }else if(!isBitboardFull(board)){
+        int best = -1000;
+        for(int cell = 0; cell < 9; cell++){
+            uint16_t bit = (uint16_t)(1u << cell);
+            if(occupiedCells(board) & bit)
+                continue;
+            Bitboard child = board;
+            if(crossToMove)
+                child.cross |= bit;
+            else
+                child.nought |= bit;
+
+            // the child's value is from the opponent's side, every ply pulls a result one step towards a draw
+            // so quicker wins and slower losses score better
+            int value = -solve(child);
+            if(value > 0)
+                value--;
+            else if(value < 0)
+                value++;
+
+            // ties keep the first cell in row-major order
+            if(value > best){
+                best = value;
+                entry.move = (int8_t)cell;
+            }
+        }
+        entry.value = (int8_t)best;
+    }
+
+    solved[index] = true;
+    table[index] = entry;
+    return entry.value;
+}
+
+int main(int argc, char **argv){
+    if(argc != 2){
+        fprintf(stderr, "usage: %s <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    for(int mask = 0; mask < 512; mask++){
+        int power = 1;
+        for(int cell = 0; cell < 9; cell++){
+            if(mask & (1 << cell))
+                base3[mask] += power;
+            power *= 3;
+        }
+    }
+
+    // every entry starts as unreachable, solving from the empty board fills in all reachable positions
+    for(int i = 0; i < MOVE_TABLE_SIZE; i++){
+        table[i].move = -1;
+        table[i].value = 0;
+    }
+    Bitboard empty = {0, 0};
+    solve(empty);
+
+    FILE *out = fopen(argv[1], "w");
+    if(out == NULL){
+        fprintf(stderr, "unable to open %s for writing\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "// Generated by tools/gen_move_table.c, do not edit.\n");
+    fprintf(out, "#include <include/move_table.h>\n\n");
+    fprintf(out, "const uint16_t BASE3_OF_MASK[512] = {");
+    for(int mask = 0; mask < 512; mask++)
+        fprintf(out, "%s%u%s", mask % 16 == 0 ? "\n    " : " ", base3[mask], mask == 511 ? "" : ",");
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "const MoveTableEntry MOVE_TABLE[MOVE_TABLE_SIZE] = {");
+    for(int i = 0; i < MOVE_TABLE_SIZE; i++)
+        fprintf(out, "%s{%d,%d}%s", i % 12 == 0 ? "\n    " : " ", table[i].move, table[i].value, i == MOVE_TABLE_SIZE - 1 ? "" : ",");
+    fprintf(out, "\n};\n");
+
+    fclose(out);
+    return 0;
+}
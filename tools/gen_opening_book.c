@@ -0,0 +1,283 @@
+// Builds the opening book the gui and tui load at startup, see include/opening_book.h for the file format.
+// usage: ttt-book [-p plies] [-d depth] [-t threads] -o file size:winLength[:depth] ...
+//
+// Walks every opening of each board up to plies pieces, once with the AI playing X and once with it playing O.
+// Wherever the AI is to move the position is solved with solvePositions and only the book move is followed,
+// wherever the opponent is to move every reply is followed, so the book covers whatever the player tries.
+// On boards larger than FULL_WIDTH_MAX_SIZE replies are limited to cells near a piece, like the search does.
+// Positions are merged under their symmetry-canonical key, so each is solved once per orientation class.
+#include <include/batch.h>
+#include <include/game.h>
+#include <include/opening_book.h>
+#include <string.h>
+
+#define DEFAULT_PLIES 4
+#define DEFAULT_DEPTH 6
+#define MAX_BOOK_BOARDS 16
+
+/// @brief A position of the walk, along with the side the AI plays in the line that reached it.
+typedef struct BookNode{
+    BatchPosition position;
+    uint64_t key;
+    int aiSide; // BOARD_CROSS or BOARD_NOUGHT
+}BookNode;
+
+/// @brief Growable array, the walk doesn't know in advance how many positions a ply has.
+typedef struct NodeList{
+    BookNode *nodes;
+    size_t count;
+    size_t capacity;
+}NodeList;
+
+typedef struct EntryList{
+    BookEntry *entries;
+    size_t count;
+    size_t capacity;
+}EntryList;
+
+static void *growArray(void *array, size_t *capacity, size_t elementSize){
+    *capacity = *capacity == 0 ? 1024 : *capacity * 2;
+    void *grown = realloc(array, *capacity * elementSize);
+    if(unlikely(grown == NULL)){
+        fprintf(stderr, "Memory allocation failed in growArray! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    return grown;
+}
+
+static void addNode(NodeList *list, int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], BoardConfig config, int toMove, int aiSide){
+    if(list->count == list->capacity)
+        list->nodes = growArray(list->nodes, &list->capacity, sizeof(BookNode));
+    BookNode *node = &list->nodes[list->count++];
+    memcpy(node->position.board, board, sizeof(node->position.board));
+    node->position.config = config;
+    node->position.toMove = toMove;
+    int symmetry;
+    node->key = openingBookKey(board, config, &symmetry);
+    node->aiSide = aiSide;
+}
+
+static void addEntry(EntryList *list, BookEntry entry){
+    if(list->count == list->capacity)
+        list->entries = growArray(list->entries, &list->capacity, sizeof(BookEntry));
+    list->entries[list->count++] = entry;
+}
+
+static int compareNodes(const void *a, const void *b){
+    const BookNode *x = a;
+    const BookNode *y = b;
+    if(x->key != y->key)
+        return x->key < y->key ? -1 : 1;
+    return x->aiSide - y->aiSide;
+}
+
+static int compareEntries(const void *a, const void *b){
+    const BookEntry *x = a;
+    const BookEntry *y = b;
+    if(x->key != y->key)
+        return x->key < y->key ? -1 : 1;
+    return 0;
+}
+
+// drops positions that are a rotation or reflection of one already in the list with the same AI side
+static void removeDuplicates(NodeList *list){
+    if(list->count == 0)
+        return;
+    qsort(list->nodes, list->count, sizeof(BookNode), compareNodes);
+    size_t kept = 1;
+    for(size_t i = 1; i < list->count; i++){
+        if(compareNodes(&list->nodes[i], &list->nodes[kept - 1]) != 0)
+            list->nodes[kept++] = list->nodes[i];
+    }
+    list->count = kept;
+}
+
+// true if a piece sits within NEIGHBOUR_RADIUS of row, col
+static bool hasNeighbour(int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int size, int row, int col){
+    for(int r = max(0, row - NEIGHBOUR_RADIUS); r <= min(size - 1, row + NEIGHBOUR_RADIUS); r++){
+        for(int c = max(0, col - NEIGHBOUR_RADIUS); c <= min(size - 1, col + NEIGHBOUR_RADIUS); c++){
+            if(board[r][c] != BOARD_EMPTY)
+                return true;
+        }
+    }
+    return false;
+}
+
+// places a piece and queues the position after it, unless the move ended the game
+static void playMove(NodeList *next, BookNode *node, int row, int col, int plies){
+    BatchPosition *position = &node->position;
+    BoardConfig config = position->config;
+    int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+    memcpy(board, position->board, sizeof(board));
+    board[row][col] = position->toMove;
+    if(isWinningMove(board, config, row, col) || plies >= config.size * config.size)
+        return;
+    addNode(next, board, config, position->toMove == BOARD_CROSS ? BOARD_NOUGHT : BOARD_CROSS, node->aiSide);
+}
+
+// walks the openings of one board and appends a book entry for every position where the AI is to move
+static void buildBoard(EntryList *book, BoardConfig config, int plies, int depth, int threads){
+    int size = config.size;
+    bool restrictToNeighbours = size > FULL_WIDTH_MAX_SIZE;
+    int empty[MAX_BOARD_SIZE][MAX_BOARD_SIZE] = {0};
+
+    NodeList current = {0};
+    NodeList next = {0};
+    addNode(&current, empty, config, BOARD_CROSS, BOARD_CROSS);
+    addNode(&current, empty, config, BOARD_CROSS, BOARD_NOUGHT);
+
+    for(int ply = 0; ply < plies && current.count > 0; ply++){
+        removeDuplicates(&current);
+
+        // solve every position where the AI is to move in one batch, that's where all the time goes
+        size_t solveCount = 0;
+        for(size_t i = 0; i < current.count; i++){
+            if(current.nodes[i].position.toMove == current.nodes[i].aiSide)
+                solveCount++;
+        }
+        BatchPosition *positions = malloc(max(1, solveCount) * sizeof(BatchPosition));
+        BatchResult *results = malloc(max(1, solveCount) * sizeof(BatchResult));
+        if(unlikely(positions == NULL || results == NULL)){
+            fprintf(stderr, "Memory allocation failed in buildBoard! This might be an Operating System Issue! Terminating.\n");
+            exit(1);
+        }
+        size_t solved = 0;
+        for(size_t i = 0; i < current.count; i++){
+            if(current.nodes[i].position.toMove == current.nodes[i].aiSide)
+                positions[solved++] = current.nodes[i].position;
+        }
+        long long start = currentTimeMillis();
+        solvePositions(positions, results, (int)solveCount, depth, threads);
+
+        solved = 0;
+        size_t added = 0;
+        for(size_t i = 0; i < current.count; i++){
+            BookNode *node = &current.nodes[i];
+            if(node->position.toMove == node->aiSide){
+                BatchResult *result = &results[solved++];
+                if(result->move.a < 0)
+                    continue;
+                // store the move the way it looks in the canonical orientation, the probe turns it back
+                int symmetry;
+                BookEntry entry = {0};
+                entry.key = openingBookKey(node->position.board, config, &symmetry);
+                entry.cell = (uint8_t)transformBookCell(result->move.a * size + result->move.b, size, symmetry);
+                entry.value = (int16_t)result->value;
+                entry.size = (uint8_t)size;
+                entry.winLength = (uint8_t)config.winLength;
+                entry.depth = (uint8_t)depth;
+                addEntry(book, entry);
+                added++;
+                playMove(&next, node, result->move.a, result->move.b, ply + 1);
+            }else{
+                for(int row = 0; row < size; row++){
+                    for(int col = 0; col < size; col++){
+                        if(node->position.board[row][col] != BOARD_EMPTY)
+                            continue;
+                        if(restrictToNeighbours && ply > 0 && !hasNeighbour(node->position.board, size, row, col))
+                            continue;
+                        playMove(&next, node, row, col, ply + 1);
+                    }
+                }
+            }
+        }
+        println("%dx%d, %d in a row, ply %d: %zu positions, %zu solved in %lld ms", size, size, config.winLength, ply,
+                current.count, added, currentTimeMillis() - start);
+        free(positions);
+        free(results);
+
+        NodeList swap = current;
+        current = next;
+        next = swap;
+        next.count = 0;
+    }
+    free(current.nodes);
+    free(next.nodes);
+}
+
+static bool writeBook(const char *path, EntryList *book){
+    qsort(book->entries, book->count, sizeof(BookEntry), compareEntries);
+    // the same position can be reached with either side as the AI, it only needs one entry
+    size_t kept = 0;
+    for(size_t i = 0; i < book->count; i++){
+        if(kept == 0 || book->entries[i].key != book->entries[kept - 1].key)
+            book->entries[kept++] = book->entries[i];
+    }
+    book->count = kept;
+
+    FILE *file = fopen(path, "wb");
+    if(file == NULL){
+        fprintf(stderr, "can't open %s for writing\n", path);
+        return false;
+    }
+    BookHeader header = {0};
+    memcpy(header.magic, OPENING_BOOK_MAGIC, sizeof(OPENING_BOOK_MAGIC));
+    header.version = OPENING_BOOK_VERSION;
+    header.entrySize = sizeof(BookEntry);
+    header.entryCount = book->count;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+                && fwrite(book->entries, sizeof(BookEntry), book->count, file) == book->count;
+    if(fclose(file) != 0 || !written){
+        fprintf(stderr, "failed to write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+static void usage(const char *name){
+    fprintf(stderr, "usage: %s [-p plies] [-d depth] [-t threads] -o file size:winLength[:depth] ...\n", name);
+}
+
+int main(int argc, char **argv){
+    int plies = DEFAULT_PLIES;
+    int depth = DEFAULT_DEPTH;
+    int threads = cpuCount();
+    const char *path = NULL;
+    BoardConfig boards[MAX_BOOK_BOARDS];
+    int boardDepths[MAX_BOOK_BOARDS];
+    int boardCount = 0;
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "-p") == 0 && i + 1 < argc){
+            plies = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "-d") == 0 && i + 1 < argc){
+            depth = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc){
+            threads = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc){
+            path = argv[++i];
+        }else if(argv[i][0] != '-' && boardCount < MAX_BOOK_BOARDS){
+            int size, winLength, boardDepth = -1;
+            if(sscanf(argv[i], "%d:%d:%d", &size, &winLength, &boardDepth) < 2
+               || size < 4 || size > MAX_BOARD_SIZE || winLength < 1 || winLength > size){
+                // 3x3 is left out, the move table already plays it perfectly
+                fprintf(stderr, "%s: expected size:winLength[:depth] with a size from 4 to %d\n", argv[i], MAX_BOARD_SIZE);
+                return 1;
+            }
+            boards[boardCount] = (BoardConfig){size, winLength};
+            boardDepths[boardCount] = boardDepth;
+            boardCount++;
+        }else{
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if(path == NULL || boardCount == 0){
+        usage(argv[0]);
+        return 1;
+    }
+    if(plies < 1 || depth < 1 || threads < 1){
+        fprintf(stderr, "plies, depth and threads must be at least 1\n");
+        return 1;
+    }
+
+    EntryList book = {0};
+    long long start = currentTimeMillis();
+    for(int i = 0; i < boardCount; i++)
+        buildBoard(&book, boards[i], plies, boardDepths[i] > 0 ? boardDepths[i] : depth, threads);
+
+    if(!writeBook(path, &book))
+        return 1;
+    println("wrote %zu positions to %s in %lld ms", book.count, path, currentTimeMillis() - start);
+    free(book.entries);
+    return 0;
+}
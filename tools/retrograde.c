@@ -0,0 +1,254 @@
+// Solves every position of a board by retrograde analysis and writes the results for the engine to map,
+// see include/solved_database.h for the file format.
+// usage: ttt-retrograde [-t threads] [-o file] size:winLength
+//
+// Moves only ever add a piece, so the positions with p pieces only lead to positions with p + 1.
+// The board is solved one piece count at a time from the full board down to the empty one: terminal positions
+// are scored directly, every other one is a win if some move reaches a loss for the opponent, else a draw if some
+// move reaches a draw, else a loss. The positions of one piece count are split between the threads of a pool.
+#include <include/solved_database.h>
+#include <include/thread_pool.h>
+#include <string.h>
+
+// k-in-a-row lines of a board with at most SOLVED_DATABASE_MAX_CELLS cells: 4x4 has 10, 4x4 with 3 in a row 24
+#define MAX_WIN_MASKS 64
+
+/// @brief Everything the threads of one piece count share.
+typedef struct RetrogradeLayer{
+    _Atomic uint8_t *results; // packed like the file, threads own whole bytes so no result is written by two threads
+    uint64_t positionCount;
+    uint64_t chunkSize; // positions per thread, a multiple of 4
+    int cells;
+    int pieces; // piece count this pass solves
+    uint64_t powers[SOLVED_DATABASE_MAX_CELLS];
+    uint32_t winMasks[MAX_WIN_MASKS];
+    int winMaskCount;
+    uint64_t counts[4]; // positions solved per result, summed over the threads
+    pthread_mutex_t countLock;
+}RetrogradeLayer;
+
+static bool hasLine(const RetrogradeLayer *layer, uint32_t pieces){
+    for(int i = 0; i < layer->winMaskCount; i++){
+        if((pieces & layer->winMasks[i]) == layer->winMasks[i])
+            return true;
+    }
+    return false;
+}
+
+static int solveRetrogradePosition(const RetrogradeLayer *layer, uint64_t index, uint32_t crosses, uint32_t noughts, int crossCount, int noughtCount){
+    int toMove = crossCount == noughtCount ? BOARD_CROSS : BOARD_NOUGHT;
+    bool crossLine = hasLine(layer, crosses);
+    bool noughtLine = hasLine(layer, noughts);
+    // the game is already over, normally won by whoever moved last
+    if(crossLine || noughtLine){
+        bool moverLine = toMove == BOARD_CROSS ? crossLine : noughtLine;
+        bool otherLine = toMove == BOARD_CROSS ? noughtLine : crossLine;
+        return otherLine || !moverLine ? SOLVED_LOSS : SOLVED_WIN;
+    }
+    if(crossCount + noughtCount == layer->cells)
+        return SOLVED_DRAW;
+
+    // every reply has one more piece and was solved in the previous pass
+    uint32_t occupied = crosses | noughts;
+    int best = SOLVED_LOSS;
+    for(int cell = 0; cell < layer->cells; cell++){
+        if(occupied & (1u << cell))
+            continue;
+        int reply = solvedResultAtomic(layer->results, index + layer->powers[cell] * toMove);
+        if(reply == SOLVED_LOSS)
+            return SOLVED_WIN;
+        if(reply == SOLVED_DRAW)
+            best = SOLVED_DRAW;
+    }
+    return best;
+}
+
+static void solveChunk(void *arg, int threadIndex){
+    RetrogradeLayer *layer = arg;
+    uint64_t start = (uint64_t)threadIndex * layer->chunkSize;
+    uint64_t end = start + layer->chunkSize < layer->positionCount ? start + layer->chunkSize : layer->positionCount;
+    if(start >= end)
+        return;
+
+    // the cells of start in base 3, then counted up one position at a time so nothing is decoded from scratch
+    int digits[SOLVED_DATABASE_MAX_CELLS];
+    uint32_t crosses = 0;
+    uint32_t noughts = 0;
+    int crossCount = 0;
+    int noughtCount = 0;
+    uint64_t rest = start;
+    for(int cell = 0; cell < layer->cells; cell++){
+        digits[cell] = rest % 3;
+        rest /= 3;
+        if(digits[cell] == BOARD_CROSS){
+            crosses |= 1u << cell;
+            crossCount++;
+        }else if(digits[cell] == BOARD_NOUGHT){
+            noughts |= 1u << cell;
+            noughtCount++;
+        }
+    }
+
+    uint64_t counts[4] = {0};
+    uint8_t packed = 0;
+    for(uint64_t index = start; index < end; index++){
+        // only legal positions of this pass, X always has as many pieces as O or one more
+        if(crossCount + noughtCount == layer->pieces && (crossCount == noughtCount || crossCount == noughtCount + 1)){
+            int result = solveRetrogradePosition(layer, index, crosses, noughts, crossCount, noughtCount);
+            packed |= result << ((index & 3) * 2);
+            counts[result]++;
+        }
+        if((index & 3) == 3 || index + 1 == end){
+            if(packed != 0)
+                atomic_fetch_or_explicit(&layer->results[index >> 2], packed, memory_order_relaxed);
+            packed = 0;
+        }
+
+        // next position: empty -> X -> O, carrying into the next cell after O
+        for(int cell = 0; cell < layer->cells; cell++){
+            uint32_t bit = 1u << cell;
+            if(digits[cell] == BOARD_EMPTY){
+                digits[cell] = BOARD_CROSS;
+                crosses |= bit;
+                crossCount++;
+                break;
+            }
+            if(digits[cell] == BOARD_CROSS){
+                digits[cell] = BOARD_NOUGHT;
+                crosses &= ~bit;
+                noughts |= bit;
+                crossCount--;
+                noughtCount++;
+                break;
+            }
+            digits[cell] = BOARD_EMPTY;
+            noughts &= ~bit;
+            noughtCount--;
+        }
+    }
+
+    pthread_mutex_lock(&layer->countLock);
+    for(int i = 0; i < 4; i++)
+        layer->counts[i] += counts[i];
+    pthread_mutex_unlock(&layer->countLock);
+}
+
+// fills winMasks with every line of winLength cells on the board
+static void buildWinMasks(RetrogradeLayer *layer, BoardConfig config){
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    layer->winMaskCount = 0;
+    for(int row = 0; row < config.size; row++){
+        for(int col = 0; col < config.size; col++){
+            for(int d = 0; d < 4; d++){
+                int endRow = row + directions[d][0] * (config.winLength - 1);
+                int endCol = col + directions[d][1] * (config.winLength - 1);
+                if(endRow < 0 || endRow >= config.size || endCol < 0 || endCol >= config.size)
+                    continue;
+                uint32_t mask = 0;
+                for(int i = 0; i < config.winLength; i++)
+                    mask |= 1u << ((row + directions[d][0] * i) * config.size + col + directions[d][1] * i);
+                layer->winMasks[layer->winMaskCount++] = mask;
+            }
+        }
+    }
+}
+
+static bool writeDatabase(const char *path, BoardConfig config, RetrogradeLayer *layer){
+    FILE *file = fopen(path, "wb");
+    if(file == NULL){
+        fprintf(stderr, "can't open %s for writing\n", path);
+        return false;
+    }
+    SolvedHeader header = {0};
+    memcpy(header.magic, SOLVED_DATABASE_MAGIC, sizeof(SOLVED_DATABASE_MAGIC));
+    header.version = SOLVED_DATABASE_VERSION;
+    header.size = (uint8_t)config.size;
+    header.winLength = (uint8_t)config.winLength;
+    header.positionCount = layer->positionCount;
+    size_t bytes = (layer->positionCount + 3) / 4;
+    // nobody writes to the results any more, plain bytes from here on
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+                && fwrite((const uint8_t *)layer->results, 1, bytes, file) == bytes;
+    if(fclose(file) != 0 || !written){
+        fprintf(stderr, "failed to write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv){
+    int threads = cpuCount();
+    const char *path = NULL;
+    BoardConfig config = {0, 0};
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "-t") == 0 && i + 1 < argc){
+            threads = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc){
+            path = argv[++i];
+        }else if(argv[i][0] != '-' && config.size == 0){
+            if(sscanf(argv[i], "%d:%d", &config.size, &config.winLength) != 2){
+                config.size = 0;
+                break;
+            }
+        }else{
+            config.size = 0;
+            break;
+        }
+    }
+    if(config.size < 1 || config.size * config.size > SOLVED_DATABASE_MAX_CELLS
+       || config.winLength < 1 || config.winLength > config.size || threads < 1){
+        fprintf(stderr, "usage: %s [-t threads] [-o file] size:winLength, with at most %d cells\n", argv[0], SOLVED_DATABASE_MAX_CELLS);
+        return 1;
+    }
+    char defaultPath[64];
+    if(path == NULL){
+        solvedDatabasePath(config, defaultPath, sizeof(defaultPath));
+        path = defaultPath;
+    }
+
+    RetrogradeLayer *layer = calloc(1, sizeof(RetrogradeLayer));
+    if(unlikely(layer == NULL)){
+        fprintf(stderr, "Memory allocation failed in main! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    layer->cells = config.size * config.size;
+    layer->positionCount = 1;
+    for(int cell = 0; cell < layer->cells; cell++){
+        layer->powers[cell] = layer->positionCount;
+        layer->positionCount *= 3;
+    }
+    buildWinMasks(layer, config);
+    layer->results = calloc((layer->positionCount + 3) / 4, 1);
+    if(unlikely(layer->results == NULL)){
+        fprintf(stderr, "Memory allocation failed in main! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+    // whole bytes per thread, rounded up so the last thread never gets more than the others
+    layer->chunkSize = ((layer->positionCount + threads - 1) / threads + 3) / 4 * 4;
+    pthread_mutex_init(&layer->countLock, NULL);
+
+    ThreadPool *pool = createThreadPool(threads);
+    long long start = currentTimeMillis();
+    for(int pieces = layer->cells; pieces >= 0; pieces--){
+        layer->pieces = pieces;
+        memset(layer->counts, 0, sizeof(layer->counts));
+        runThreadPool(pool, solveChunk, layer);
+        println("%2d pieces: %10llu wins %10llu draws %10llu losses for the side to move", pieces,
+                (unsigned long long)layer->counts[SOLVED_WIN], (unsigned long long)layer->counts[SOLVED_DRAW],
+                (unsigned long long)layer->counts[SOLVED_LOSS]);
+    }
+    long long elapsed = currentTimeMillis() - start;
+    destroyThreadPool(pool);
+
+    static const char *names[4] = {"unknown", "a loss", "a draw", "a win"};
+    println("%dx%d with %d in a row is %s for X, solved in %lld ms on %d threads", config.size, config.size, config.winLength,
+            names[solvedResultAtomic(layer->results, 0)], elapsed, threads);
+
+    bool written = writeDatabase(path, config, layer);
+    if(written)
+        println("wrote %llu positions to %s", (unsigned long long)layer->positionCount, path);
+    pthread_mutex_destroy(&layer->countLock);
+    free((void *)layer->results);
+    free(layer);
+    return written ? 0 : 1;
+}
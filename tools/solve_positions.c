@@ -0,0 +1,147 @@
+// Offline analysis tool, solves every position in a file and prints the best move and minimax value of each.
+// usage: ttt-solve [-d depth] [-t threads] [file]
+//
+// Reads standard input when no file is given. One position per line:
+//     <size> <win length> <side to move X|O> <cells>
+// where cells lists the size * size cells row by row as X, O or '.', e.g. "3 3 O X...O..X." for
+// the classic board. Empty lines and lines starting with '#' are skipped.
+// Prints "<line> <row> <col> <value>" per position in input order, row and col count from 0 and are -1 when the game
+// is already over. Positions are solved in chunks so the output streams while the rest of the file is still being read.
+#include <include/batch.h>
+#include <string.h>
+
+// positions read and solved together, enough to keep every core busy without holding the whole file in memory
+#define CHUNK_SIZE 4096
+#define LINE_LENGTH 512
+
+// parses one input line into position, returns false and prints why if the line is invalid
+static bool parsePosition(const char *line, int lineNumber, BatchPosition *position){
+    char side;
+    char cells[MAX_BOARD_SIZE * MAX_BOARD_SIZE + 1];
+    int size, winLength, cellsStart;
+    if(sscanf(line, "%d %d %c %n", &size, &winLength, &side, &cellsStart) != 3 || line[cellsStart] == '\0'){
+        fprintf(stderr, "line %d: expected <size> <win length> <X|O> <cells>\n", lineNumber);
+        return false;
+    }
+    // the field has to fit cells whatever MAX_BOARD_SIZE is, a longer one is reported and never copied
+    size_t cellCount = strcspn(line + cellsStart, " \t\r\n");
+    if(cellCount >= sizeof(cells)){
+        fprintf(stderr, "line %d: more than %d cells\n", lineNumber, MAX_BOARD_SIZE * MAX_BOARD_SIZE);
+        return false;
+    }
+    memcpy(cells, line + cellsStart, cellCount);
+    cells[cellCount] = '\0';
+    if(size < 1 || size > MAX_BOARD_SIZE || winLength < 1 || winLength > size){
+        fprintf(stderr, "line %d: unsupported board %d with %d in a row\n", lineNumber, size, winLength);
+        return false;
+    }
+    side = toupper(side);
+    if((side != 'X' && side != 'O') || (int)strlen(cells) != size * size){
+        fprintf(stderr, "line %d: expected X or O to move and %d cells\n", lineNumber, size * size);
+        return false;
+    }
+
+    memset(position->board, 0, sizeof(position->board));
+    for(int i = 0; i < size * size; i++){
+        char c = toupper(cells[i]);
+        if(c == 'X'){
+            position->board[i / size][i % size] = BOARD_CROSS;
+        }else if(c == 'O'){
+            position->board[i / size][i % size] = BOARD_NOUGHT;
+        }else if(c != '.'){
+            fprintf(stderr, "line %d: unexpected cell '%c'\n", lineNumber, cells[i]);
+            return false;
+        }
+    }
+    position->config.size = size;
+    position->config.winLength = winLength;
+    position->toMove = side == 'X' ? BOARD_CROSS : BOARD_NOUGHT;
+    return true;
+}
+
+static void solveChunk(BatchPosition *positions, BatchResult *results, int *lineNumbers, int count, int depth, int threads){
+    solvePositions(positions, results, count, depth, threads);
+    for(int i = 0; i < count; i++)
+        printf("%d %d %d %d\n", lineNumbers[i], results[i].move.a, results[i].move.b, results[i].value);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv){
+    int depth = CLASSIC_MAX_DEPTH;
+    int threads = cpuCount();
+    const char *path = NULL;
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "-d") == 0 && i + 1 < argc){
+            depth = atoi(argv[++i]);
+        }else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc){
+            threads = atoi(argv[++i]);
+        }else if(argv[i][0] != '-' && path == NULL){
+            path = argv[i];
+        }else{
+            fprintf(stderr, "usage: %s [-d depth] [-t threads] [file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(depth < 1 || threads < 1){
+        fprintf(stderr, "depth and threads must be at least 1\n");
+        return 1;
+    }
+
+    FILE *input = path == NULL ? stdin : fopen(path, "r");
+    if(input == NULL){
+        fprintf(stderr, "unable to open %s\n", path);
+        return 1;
+    }
+
+    BatchPosition *positions = malloc(sizeof(BatchPosition) * CHUNK_SIZE);
+    BatchResult *results = malloc(sizeof(BatchResult) * CHUNK_SIZE);
+    int *lineNumbers = malloc(sizeof(int) * CHUNK_SIZE);
+    // Check if malloc failed to allocate memory, sometimes it can happen if the OS is unable to alloc.
+    if(unlikely(positions == NULL || results == NULL || lineNumbers == NULL)){
+        fprintf(stderr, "Memory allocation failed in ttt-solve! This might be an Operating System Issue! Terminating.\n");
+        exit(1);
+    }
+
+    char line[LINE_LENGTH];
+    int lineNumber = 0;
+    int count = 0;
+    int errors = 0;
+    while(fgets(line, sizeof(line), input) != NULL){
+        lineNumber++;
+        // a line that didn't fit the buffer is reported and the rest of it skipped, so it isn't read as another line
+        if(strchr(line, '\n') == NULL){
+            int next = fgetc(input);
+            if(next != EOF && next != '\n'){
+                fprintf(stderr, "line %d: longer than %d characters\n", lineNumber, LINE_LENGTH - 2);
+                while(next != EOF && next != '\n')
+                    next = fgetc(input);
+                errors++;
+                continue;
+            }
+        }
+        const char *start = line;
+        while(isspace((unsigned char)*start))
+            start++;
+        if(*start == '\0' || *start == '#')
+            continue;
+
+        if(!parsePosition(start, lineNumber, &positions[count])){
+            errors++;
+            continue;
+        }
+        lineNumbers[count++] = lineNumber;
+        if(count == CHUNK_SIZE){
+            solveChunk(positions, results, lineNumbers, count, depth, threads);
+            count = 0;
+        }
+    }
+    if(count > 0)
+        solveChunk(positions, results, lineNumbers, count, depth, threads);
+
+    if(input != stdin)
+        fclose(input);
+    free(positions);
+    free(results);
+    free(lineNumbers);
+    return errors == 0 ? 0 : 1;
+}